@@ -0,0 +1,397 @@
+#include "auction.hpp"
+#include "counters.hpp"
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <thread>
+
+namespace transport
+{
+
+static const long long infinity = std::numeric_limits<long long>::max();
+
+bool Auction::suits(const Matrix &matrix)
+{
+    if (!matrix.transitArcs().empty())
+        return false;
+    for (int i = 0; i < matrix.rows(); ++i)
+    {
+        if (matrix.supplierAt(i) > maxAmount)
+            return false;
+    }
+    for (int j = 0; j < matrix.columns(); ++j)
+    {
+        if (matrix.consumersAt(j) > maxAmount)
+            return false;
+    }
+    return true;
+}
+
+// The matrix has to be closed: persons and objects are then equally many.
+Auction::Auction(const Matrix &matrix, int threads) : matrix(matrix), threads(std::max(1, threads))
+{
+    firstPerson.push_back(0);
+    for (int i = 0; i < matrix.rows(); ++i)
+    {
+        personRow.insert(personRow.end(), matrix.supplierAt(i), i);
+        firstPerson.push_back(personRow.size());
+    }
+    firstObject.push_back(0);
+    for (int j = 0; j < matrix.columns(); ++j)
+    {
+        objectColumn.insert(objectColumn.end(), matrix.consumersAt(j), j);
+        firstObject.push_back(objectColumn.size());
+    }
+    size = personRow.size();
+    scale = size + 1;
+    long long maxCost = 0;
+    for (int i = 0; i < matrix.rows(); ++i)
+    {
+        for (const auto &route : matrix.routesOf(i))
+        {
+            maxCost = std::max(maxCost, (long long)route.cost);
+        }
+    }
+    spread = maxCost * scale + 1;
+    price.assign(size, 0);
+    profit.assign(size, 0);
+}
+
+// Cheapest and second cheapest cost + price over the objects the person can
+// reach. A person with a single object bids as if the next one were spread
+// dearer, which is still a valid (finite) bid.
+void Auction::bestObjects(int person, int &object, long long &best, long long &second, long long &cost) const
+{
+    object = -1;
+    best = second = infinity;
+    for (const auto &route : matrix.routesOf(personRow[person]))
+    {
+        long long scaled = (long long)route.cost * scale;
+        for (int o = firstObject[route.column]; o < firstObject[route.column + 1]; ++o)
+        {
+            long long value = scaled + price[o];
+            if (value < best)
+            {
+                second = best;
+                best = value;
+                object = o;
+                cost = scaled;
+            }
+            else if (value < second)
+                second = value;
+        }
+    }
+    if (second == infinity)
+        second = best + spread;
+}
+
+// Gauss-Seidel forward auction: one bid at a time, prices raised at once.
+void Auction::forward(long long epsilon)
+{
+    std::deque<int> unassigned;
+    for (int p = 0; p < size; ++p)
+    {
+        unassigned.push_back(p);
+    }
+    while (!unassigned.empty())
+    {
+        int p = unassigned.front();
+        unassigned.pop_front();
+        int o;
+        long long best, second, cost;
+        bestObjects(p, o, best, second, cost);
+        price[o] = second - cost + epsilon;
+        bids++;
+        if (owner[o] != -1)
+        {
+            assigned[owner[o]] = -1;
+            unassigned.push_back(owner[o]);
+        }
+        owner[o] = p;
+        assigned[p] = o;
+    }
+}
+
+// Jacobi forward auction: all unassigned persons bid against the same
+// prices, split across threads, then every object goes to its highest bid.
+void Auction::forwardJacobi(long long epsilon)
+{
+    std::vector<int> unassigned(size), bidObject, winner(size, -1), touched;
+    std::vector<long long> bidPrice, top(size);
+    for (int p = 0; p < size; ++p)
+    {
+        unassigned[p] = p;
+    }
+    while (!unassigned.empty())
+    {
+        int count = unassigned.size();
+        bidObject.resize(count);
+        bidPrice.resize(count);
+        auto work = [&](int from, int to)
+        {
+            for (int k = from; k < to; ++k)
+            {
+                long long best, second, cost;
+                bestObjects(unassigned[k], bidObject[k], best, second, cost);
+                bidPrice[k] = second - cost + epsilon;
+            }
+            ALGOM_MERGE_THREAD();
+        };
+        int parts = count >= 256 ? threads : 1;
+        std::vector<std::thread> pool;
+        for (int t = 1; t < parts; ++t)
+        {
+            pool.emplace_back(work, (long long)count * t / parts, (long long)count * (t + 1) / parts);
+        }
+        work(0, count / parts);
+        for (auto &thread : pool)
+        {
+            thread.join();
+        }
+        bids += count;
+
+        touched.clear();
+        for (int k = 0; k < count; ++k)
+        {
+            int o = bidObject[k];
+            if (winner[o] == -1)
+            {
+                touched.push_back(o);
+                winner[o] = k;
+                top[o] = bidPrice[k];
+            }
+            else if (bidPrice[k] > top[o])
+            {
+                winner[o] = k;
+                top[o] = bidPrice[k];
+            }
+        }
+        std::vector<int> losers;
+        for (int k = 0; k < count; ++k)
+        {
+            if (winner[bidObject[k]] != k)
+                losers.push_back(unassigned[k]);
+        }
+        for (int o : touched)
+        {
+            int p = unassigned[winner[o]];
+            if (owner[o] != -1)
+            {
+                assigned[owner[o]] = -1;
+                losers.push_back(owner[o]);
+            }
+            owner[o] = p;
+            assigned[p] = o;
+            price[o] = top[o];
+            winner[o] = -1;
+        }
+        unassigned.swap(losers);
+    }
+}
+
+// Forward-reverse auction (Bertsekas and Castanon). Persons keep profits
+// next to the object prices; persons bid for objects and unassigned objects
+// bid for persons, switching direction whenever a step has added an
+// assignment.
+void Auction::forwardReverse(long long epsilon)
+{
+    for (int p = 0; p < size; ++p)
+    {
+        int o;
+        long long best, second, cost;
+        bestObjects(p, o, best, second, cost);
+        profit[p] = -best;
+    }
+    std::deque<int> persons, objects;
+    for (int k = 0; k < size; ++k)
+    {
+        persons.push_back(k);
+        objects.push_back(k);
+    }
+    int done = 0;
+    bool isForward = true;
+    while (done < size)
+    {
+        if (isForward)
+        {
+            int p = persons.front();
+            persons.pop_front();
+            if (assigned[p] != -1)
+                continue;
+            int o;
+            long long best, second, cost;
+            bestObjects(p, o, best, second, cost);
+            price[o] = second - cost + epsilon;
+            profit[p] = -second - epsilon;
+            bids++;
+            if (owner[o] != -1)
+            {
+                assigned[owner[o]] = -1;
+                persons.push_back(owner[o]);
+            }
+            else
+            {
+                done++;
+                isForward = false;
+            }
+            owner[o] = p;
+            assigned[p] = o;
+        }
+        else
+        {
+            int o = objects.front();
+            objects.pop_front();
+            if (owner[o] != -1)
+                continue;
+            int column = objectColumn[o], person = -1;
+            long long best = -infinity, second = -infinity, benefit = 0;
+            for (const auto &[row, index] : matrix.routesTo(column))
+            {
+                long long scaled = -(long long)matrix.routesOf(row)[index].cost * scale;
+                for (int p = firstPerson[row]; p < firstPerson[row + 1]; ++p)
+                {
+                    long long value = scaled - profit[p];
+                    if (value > best)
+                    {
+                        second = best;
+                        best = value;
+                        person = p;
+                        benefit = scaled;
+                    }
+                    else if (value > second)
+                        second = value;
+                }
+            }
+            if (second == -infinity)
+                second = best - spread;
+            profit[person] = benefit - second + epsilon;
+            price[o] = second - epsilon;
+            bids++;
+            if (assigned[person] != -1)
+            {
+                owner[assigned[person]] = -1;
+                objects.push_back(assigned[person]);
+            }
+            else
+            {
+                done++;
+                isForward = true;
+            }
+            owner[o] = person;
+            assigned[person] = o;
+        }
+        if (isForward && persons.empty())
+            isForward = false;
+        if (!isForward && objects.empty())
+            isForward = true;
+    }
+}
+
+// Hopcroft-Karp over persons and objects: a sparse table may leave some
+// demand unreachable, and the auction would then bid forever.
+bool Auction::matchable() const
+{
+    std::vector<int> match(size, -1), matched(size, -1), dist(size);
+    auto neighbours = [&](int p, auto &&visit)
+    {
+        for (const auto &route : matrix.routesOf(personRow[p]))
+        {
+            for (int o = firstObject[route.column]; o < firstObject[route.column + 1]; ++o)
+            {
+                if (visit(o))
+                    return true;
+            }
+        }
+        return false;
+    };
+    int total = 0;
+    while (true)
+    {
+        std::deque<int> queue;
+        for (int p = 0; p < size; ++p)
+        {
+            dist[p] = match[p] == -1 ? 0 : -1;
+            if (match[p] == -1)
+                queue.push_back(p);
+        }
+        bool found = false;
+        while (!queue.empty())
+        {
+            int p = queue.front();
+            queue.pop_front();
+            neighbours(p, [&](int o)
+                       {
+                           int q = matched[o];
+                           if (q == -1)
+                               found = true;
+                           else if (dist[q] == -1)
+                           {
+                               dist[q] = dist[p] + 1;
+                               queue.push_back(q);
+                           }
+                           return false; });
+        }
+        if (!found)
+            break;
+        auto augment = [&](int p, auto &&self) -> bool
+        {
+            bool ok = neighbours(p, [&](int o)
+                                 {
+                                     int q = matched[o];
+                                     if (q == -1 || (dist[q] == dist[p] + 1 && self(q, self)))
+                                     {
+                                         match[p] = o;
+                                         matched[o] = p;
+                                         return true;
+                                     }
+                                     return false; });
+            if (!ok)
+                dist[p] = -1;
+            return ok;
+        };
+        for (int p = 0; p < size; ++p)
+        {
+            if (match[p] == -1 && augment(p, augment))
+                total++;
+        }
+    }
+    return total == size;
+}
+
+bool Auction::run()
+{
+    if (!matrix.isDense() && !matchable())
+        return false;
+    owner.assign(size, -1);
+    assigned.assign(size, -1);
+    long long epsilon = std::max(1ll, spread / 4);
+    const long long theta = 7;
+    while (true)
+    {
+        std::fill(owner.begin(), owner.end(), -1);
+        std::fill(assigned.begin(), assigned.end(), -1);
+        if (!matrix.isDense())
+            forwardReverse(epsilon);
+        else if (threads > 1 && size >= 256)
+            forwardJacobi(epsilon);
+        else
+            forward(epsilon);
+        phases++;
+        if (epsilon == 1)
+            break;
+        epsilon = std::max(1ll, epsilon / theta);
+    }
+    return true;
+}
+
+std::vector<std::pair<int, int>> Auction::assignment() const
+{
+    std::vector<std::pair<int, int>> cells(size);
+    for (int p = 0; p < size; ++p)
+    {
+        cells[p] = {personRow[p], objectColumn[assigned[p]]};
+    }
+    return cells;
+}
+
+}
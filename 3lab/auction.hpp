@@ -0,0 +1,44 @@
+#pragma once
+#include "transport.hpp"
+#include <vector>
+
+namespace transport
+{
+
+// Bertsekas' auction for transport problems whose supplies and demands are
+// small integers: supplier i becomes s_i persons, consumer j becomes d_j
+// objects, and persons bid for objects with eps-scaling on costs multiplied
+// by persons + 1, so the last phase with eps = 1 is exactly optimal. Dense
+// tables use forward bidding, Jacobi-parallel across threads while many
+// persons are unassigned; sparse tables use forward-reverse bidding, which
+// does not stall on the long price wars forbidden routes cause.
+class Auction
+{
+private:
+    const Matrix &matrix;
+    int size = 0;
+    int threads;
+    long long scale, spread, phases = 0, bids = 0;
+    std::vector<int> personRow, objectColumn, firstObject, firstPerson;
+    std::vector<long long> price, profit;
+    std::vector<int> owner, assigned;
+
+    void bestObjects(int person, int &object, long long &best, long long &second, long long &cost) const;
+    void forward(long long epsilon);
+    void forwardJacobi(long long epsilon);
+    void forwardReverse(long long epsilon);
+    bool matchable() const;
+
+public:
+    static const unsigned long long maxAmount = 8;
+    static bool suits(const Matrix &matrix);
+
+    Auction(const Matrix &matrix, int threads);
+    bool run();
+    // (row, column) of every person and the object it holds.
+    std::vector<std::pair<int, int>> assignment() const;
+    long long bidCount() const { return bids; }
+    long long phaseCount() const { return phases; }
+};
+
+}
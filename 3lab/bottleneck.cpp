@@ -0,0 +1,224 @@
+#include "bottleneck.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace transport
+{
+
+// Edges come in pairs, so edge ^ 1 is the reverse of edge.
+int Bottleneck::addEdge(int from, int to, long long capacity, unsigned long long cost)
+{
+    forward[from].push_back(head.size());
+    head.push_back(to);
+    head.push_back(from);
+    this->cost.push_back(cost);
+    this->cost.push_back(0);
+    this->capacity.push_back(capacity);
+    this->capacity.push_back(0);
+    return head.size() - 2;
+}
+
+Bottleneck::Bottleneck(const Matrix &matrix) : matrix(matrix)
+{
+    int rows = matrix.rows(), columns = matrix.columns();
+    nodes = rows + columns + matrix.transit() + 2;
+    source = nodes - 2;
+    sink = nodes - 1;
+    forward.resize(nodes);
+
+    long long supplies = 0, demands = 0;
+    for (int i = 0; i < rows; ++i)
+    {
+        addEdge(source, i, matrix.supplierAt(i), 0);
+        supplies += matrix.supplierAt(i);
+    }
+    for (int j = 0; j < columns; ++j)
+    {
+        addEdge(rows + j, sink, matrix.consumersAt(j), 0);
+        demands += matrix.consumersAt(j);
+    }
+    required = std::min(supplies, demands);
+
+    direct.resize(rows);
+    for (int i = 0; i < rows; ++i)
+    {
+        for (const auto &route : matrix.routesOf(i))
+        {
+            direct[i].push_back(addEdge(i, rows + route.column, required, route.cost));
+        }
+    }
+    for (const auto &arc : matrix.transitArcs())
+    {
+        transit.push_back(addEdge(arc.from, arc.to, required, arc.cost));
+    }
+    for (auto &edges : forward)
+    {
+        std::stable_sort(edges.begin(), edges.end(), [this](int a, int b)
+                         { return cost[a] < cost[b]; });
+    }
+    flow.residual = capacity;
+    flow.carrying.resize(nodes);
+    flow.listed.assign(head.size(), 0);
+}
+
+// The k-th arc a scan of node looks at: forward arcs up to the threshold,
+// then the carrying reverse arcs, or -1 past the end.
+int Bottleneck::admissible(int node, int k) const
+{
+    if (k < forward[node].size())
+        return forward[node][k];
+    k -= forward[node].size();
+    return k < flow.carrying[node].size() ? flow.carrying[node][k] : -1;
+}
+
+void Bottleneck::send(int edge, long long amount)
+{
+    flow.residual[edge] -= amount;
+    flow.residual[edge ^ 1] += amount;
+    int back = edge ^ 1;
+    if ((back & 1) && !flow.listed[back])
+    {
+        flow.listed[back] = 1;
+        flow.carrying[head[edge]].push_back(back);
+    }
+}
+
+bool Bottleneck::buildLevels()
+{
+    level.assign(nodes, -1);
+    level[source] = 0;
+    std::vector<int> queue = {source};
+    for (int k = 0; k < queue.size(); ++k)
+    {
+        int node = queue[k];
+        // Emptied reverse arcs are dropped here, where no scan is under way.
+        auto &carrying = flow.carrying[node];
+        for (int c = 0; c < carrying.size();)
+        {
+            if (flow.residual[carrying[c]] == 0)
+            {
+                flow.listed[carrying[c]] = 0;
+                carrying[c] = carrying.back();
+                carrying.pop_back();
+            }
+            else
+                ++c;
+        }
+        for (int e, c = 0; (e = admissible(node, c)) != -1; ++c)
+        {
+            if (cost[e] > limit)
+            {
+                c = forward[node].size() - 1;
+                continue;
+            }
+            if (flow.residual[e] > 0 && level[head[e]] == -1)
+            {
+                level[head[e]] = level[node] + 1;
+                queue.push_back(head[e]);
+            }
+        }
+    }
+    return level[sink] != -1;
+}
+
+long long Bottleneck::augment(int node, long long pushed)
+{
+    if (node == sink)
+        return pushed;
+    for (int e; (e = admissible(node, cursor[node])) != -1; ++cursor[node])
+    {
+        if (cost[e] > limit)
+        {
+            cursor[node] = forward[node].size() - 1;
+            continue;
+        }
+        if (flow.residual[e] <= 0 || level[head[e]] != level[node] + 1)
+            continue;
+        long long sent = augment(head[e], std::min(pushed, flow.residual[e]));
+        if (sent > 0)
+        {
+            send(e, sent);
+            return sent;
+        }
+    }
+    return 0;
+}
+
+// Flow added on top of the current one, using arcs up to the threshold.
+long long Bottleneck::maxFlow(unsigned long long threshold)
+{
+    limit = threshold;
+    checks++;
+    long long total = 0;
+    while (buildLevels())
+    {
+        cursor.assign(nodes, 0);
+        while (long long sent = augment(source, std::numeric_limits<long long>::max()))
+        {
+            total += sent;
+            paths++;
+        }
+    }
+    return total;
+}
+
+bool Bottleneck::run()
+{
+    std::vector<unsigned long long> costs;
+    for (int i = 0; i < matrix.rows(); ++i)
+    {
+        for (const auto &route : matrix.routesOf(i))
+        {
+            costs.push_back(route.cost);
+        }
+    }
+    for (const auto &arc : matrix.transitArcs())
+    {
+        costs.push_back(arc.cost);
+    }
+    std::sort(costs.begin(), costs.end());
+    costs.erase(std::unique(costs.begin(), costs.end()), costs.end());
+    if (costs.empty())
+        return required == 0;
+
+    // The largest threshold decides feasibility; its flow is the answer
+    // until a cheaper threshold also ships everything.
+    Flow shortfall = flow;
+    if (maxFlow(costs.back()) < required)
+        return false;
+    Flow feasible = flow;
+    long long shipped = 0;
+    int low = -1, high = costs.size() - 1;
+    while (high - low > 1)
+    {
+        int middle = (low + high) / 2;
+        flow = shortfall;
+        long long value = shipped + maxFlow(costs[middle]);
+        if (value == required)
+        {
+            high = middle;
+            std::swap(feasible, flow);
+        }
+        else
+        {
+            low = middle;
+            shipped = value;
+            std::swap(shortfall, flow);
+        }
+    }
+    std::swap(flow, feasible);
+    best = costs[high];
+    return true;
+}
+
+long long Bottleneck::flowAt(int row, int index) const
+{
+    return flow.residual[direct[row][index] ^ 1];
+}
+
+long long Bottleneck::arcFlow(int arc) const
+{
+    return flow.residual[transit[arc] ^ 1];
+}
+
+}
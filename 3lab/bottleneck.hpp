@@ -0,0 +1,59 @@
+#pragma once
+#include "transport.hpp"
+#include <vector>
+
+namespace transport
+{
+
+// Bottleneck transport: the plan that ships everything while keeping the
+// dearest route (or transit arc) it uses as cheap as possible. The distinct
+// costs are binary-searched; each threshold is a Dinic max-flow over the
+// arcs no dearer than it. A flow that falls short stays valid for every
+// higher threshold, so it is kept and only augmented by the next check.
+// Open models need no dummy: everything the smaller side holds is shipped.
+class Bottleneck
+{
+private:
+    // Residual capacities, and per node the reverse arcs that currently
+    // carry flow back; this is all a check changes.
+    struct Flow
+    {
+        std::vector<long long> residual;
+        std::vector<std::vector<int>> carrying;
+        std::vector<char> listed;
+    };
+
+    const Matrix &matrix;
+    int nodes, source, sink;
+    long long required = 0, checks = 0, paths = 0;
+    unsigned long long limit = 0, best = 0;
+    std::vector<int> head;
+    std::vector<unsigned long long> cost;
+    std::vector<long long> capacity;
+    // Forward arcs of every node, cheapest first, so a scan stops at the
+    // first arc above the threshold.
+    std::vector<std::vector<int>> forward;
+    std::vector<std::vector<int>> direct;
+    std::vector<int> transit;
+    std::vector<int> level, cursor;
+    Flow flow;
+
+    int addEdge(int from, int to, long long capacity, unsigned long long cost);
+    int admissible(int node, int k) const;
+    void send(int edge, long long amount);
+    bool buildLevels();
+    long long augment(int node, long long pushed);
+    long long maxFlow(unsigned long long threshold);
+
+public:
+    Bottleneck(const Matrix &matrix);
+    // False if the demand cannot be met at any threshold.
+    bool run();
+    unsigned long long threshold() const { return best; }
+    long long flowAt(int row, int index) const;
+    long long arcFlow(int arc) const;
+    long long checkCount() const { return checks; }
+    long long pathCount() const { return paths; }
+};
+
+}
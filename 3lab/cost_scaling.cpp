@@ -0,0 +1,147 @@
+#include "cost_scaling.hpp"
+#include <algorithm>
+#include <deque>
+#include <limits>
+
+namespace transport
+{
+
+int CostScaling::addArc(int from, int to, long long cost, long long capacity)
+{
+    input.push_back({from, to, cost, capacity});
+    return input.size() - 1;
+}
+
+// Forward and reverse arcs are laid out per tail node, so the push loop of
+// a node walks one contiguous range.
+void CostScaling::build()
+{
+    head.assign(nodes + 1, 0);
+    for (const auto &arc : input)
+    {
+        head[arc.from + 1]++;
+        head[arc.to + 1]++;
+    }
+    for (int v = 0; v < nodes; ++v)
+    {
+        head[v + 1] += head[v];
+    }
+    std::vector<int> fill(head.begin(), head.end() - 1);
+    size_t size = 2 * input.size();
+    to.resize(size);
+    reverse.resize(size);
+    residual.resize(size);
+    cost.resize(size);
+    position.resize(input.size());
+    for (size_t k = 0; k < input.size(); ++k)
+    {
+        const Arc &arc = input[k];
+        int forward = fill[arc.from]++, backward = fill[arc.to]++;
+        to[forward] = arc.to;
+        to[backward] = arc.from;
+        reverse[forward] = backward;
+        reverse[backward] = forward;
+        residual[forward] = arc.capacity;
+        residual[backward] = 0;
+        cost[forward] = arc.cost * nodes;
+        cost[backward] = -arc.cost * nodes;
+        position[k] = forward;
+    }
+    excess = supply;
+    price.assign(nodes, 0);
+    current.assign(nodes, 0);
+}
+
+void CostScaling::relabel(int node, long long epsilon)
+{
+    long long best = std::numeric_limits<long long>::min();
+    for (int e = head[node]; e < head[node + 1]; ++e)
+    {
+        if (residual[e] > 0)
+            best = std::max(best, price[to[e]] - cost[e]);
+    }
+    price[node] = best - epsilon;
+    relabels++;
+}
+
+// Saturating every arc of negative reduced cost makes the pseudoflow
+// 0-optimal, then FIFO push/relabel discharges the excesses while keeping
+// it eps-optimal.
+void CostScaling::refine(long long epsilon)
+{
+    for (int v = 0; v < nodes; ++v)
+    {
+        for (int e = head[v]; e < head[v + 1]; ++e)
+        {
+            if (residual[e] > 0 && cost[e] + price[v] - price[to[e]] < 0)
+            {
+                long long delta = residual[e];
+                residual[e] = 0;
+                residual[reverse[e]] += delta;
+                excess[v] -= delta;
+                excess[to[e]] += delta;
+            }
+        }
+    }
+    std::deque<int> active;
+    for (int v = 0; v < nodes; ++v)
+    {
+        current[v] = head[v];
+        if (excess[v] > 0)
+            active.push_back(v);
+    }
+    while (!active.empty())
+    {
+        int v = active.front();
+        active.pop_front();
+        while (excess[v] > 0)
+        {
+            if (current[v] == head[v + 1])
+            {
+                relabel(v, epsilon);
+                current[v] = head[v];
+                continue;
+            }
+            int e = current[v];
+            int w = to[e];
+            if (residual[e] > 0 && cost[e] + price[v] - price[w] < 0)
+            {
+                long long delta = std::min(excess[v], residual[e]);
+                residual[e] -= delta;
+                residual[reverse[e]] += delta;
+                excess[v] -= delta;
+                if (excess[w] <= 0 && excess[w] + delta > 0)
+                    active.push_back(w);
+                excess[w] += delta;
+                pushes++;
+                if (residual[e] == 0)
+                    current[v]++;
+            }
+            else
+                current[v]++;
+        }
+    }
+}
+
+void CostScaling::run()
+{
+    build();
+    long long epsilon = 1;
+    for (long long it : cost)
+    {
+        epsilon = std::max(epsilon, it);
+    }
+    const long long alpha = 8;
+    do
+    {
+        epsilon = std::max(1ll, epsilon / alpha);
+        refine(epsilon);
+    } while (epsilon > 1);
+}
+
+long long CostScaling::flowAt(int arc) const
+{
+    return input[arc].capacity - residual[position[arc]];
+}
+
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <vector>
+
+namespace transport
+{
+
+// Goldberg-Tarjan cost-scaling push-relabel min-cost flow. Nodes carry a
+// supply (positive) or a demand (negative), arcs a cost and a capacity.
+// Costs are multiplied by the node count, so once a refine with eps = 1
+// finishes the flow is optimal for the original integer costs.
+class CostScaling
+{
+private:
+    struct Arc
+    {
+        int from, to;
+        long long cost, capacity;
+    };
+    int nodes;
+    std::vector<Arc> input;
+    std::vector<long long> supply;
+
+    std::vector<int> head, current, to, reverse, position;
+    std::vector<long long> residual, cost, excess, price;
+    long long pushes = 0, relabels = 0;
+
+    void build();
+    void refine(long long epsilon);
+    void relabel(int node, long long epsilon);
+
+public:
+    CostScaling(int nodes) : nodes(nodes), supply(nodes, 0) {}
+    int addArc(int from, int to, long long cost, long long capacity);
+    void setSupply(int node, long long supply) { this->supply[node] = supply; }
+    void run();
+    long long flowAt(int arc) const;
+    long long pushCount() const { return pushes; }
+    long long relabelCount() const { return relabels; }
+};
+
+}
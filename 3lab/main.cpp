@@ -1,365 +1,103 @@
+#include "transport.hpp"
+#include "counters.hpp"
 #include <iostream>
+#include <exception>
 #include <fstream>
-#include <vector>
-#include <iomanip>
-#include <algorithm>
-#include <numeric>
+#include <string>
+#include <utility>
 
-class Matrix
+static int run(int argc, char **argv)
 {
-private:
-    int m_rows, m_columns;
-    int maxColumnWidth = 0;
-    std::vector<std::vector<unsigned long long>> cost;
-    std::vector<std::vector<long long>> count;
-    std::vector<unsigned long long> suppliers;
-    std::vector<unsigned long long> consumers;
-
-public:
-    Matrix(){};
-    Matrix(std::ifstream &in);
-    int rows() const { return m_rows; }
-    int columns() const { return m_columns; }
-    unsigned long long costAt(int row, int column) const { return cost[row][column]; }
-    long long countAt(int row, int column) const { return count[row][column]; }
-    void setCountAt(int row, int column, long long count) { this->count[row][column] = count; }
-    unsigned long long supplierAt(int index) const { return suppliers[index]; }
-    unsigned long long consumersAt(int index) const { return consumers[index]; }
-    void print() const;
-    void print(std::vector<unsigned long long>& currentSupplier, std::vector<unsigned long long>& currentConsumer) const;
-    int makeClose();
-    std::vector<std::pair<int, int>> getSortedCoords() const;
-    void printDistribution() const;
-};
-
-Matrix::Matrix(std::ifstream &in)
-{
-    in >> m_rows >> m_columns;
-    cost.resize(m_rows, std::vector<unsigned long long>(m_columns));
-    count.resize(m_rows, std::vector<long long>(m_columns, -1));
-    suppliers.resize(m_rows);
-    consumers.resize(m_columns);
-    int currentWidth;
-    for (int i = 0; i < m_rows; ++i)
-    {
-        for (int j = 0; j < m_columns; ++j)
-        {
-            in >> cost[i][j];
-            currentWidth = std::to_string(cost[i][j]).size();
-            maxColumnWidth = std::max(maxColumnWidth, currentWidth);
-        }
-        in >> suppliers[i];
-        currentWidth = std::to_string(suppliers[i]).size();
-        maxColumnWidth = std::max(maxColumnWidth, currentWidth);
-    }
-    for (int i = 0; i < m_columns; ++i)
-    {
-        in >> consumers[i];
-        currentWidth = std::to_string(consumers[i]).size();
-        maxColumnWidth = std::max(maxColumnWidth, currentWidth);
-    }
-}
-
-void Matrix::print() const
-{
-    int spacing = 9;
-
-    auto printBorder = [](int m_columns, int maxColumnWidth, int spacing) -> void
-    {
-        for (int i = 0; i <= m_columns + 1; ++i)
-        {
-            std::cout << "+" << std::string((maxColumnWidth + spacing - 1), '-');
-        }
-        std::cout << "+" << std::endl;
-    };
-    std::cout << std::string(maxColumnWidth + spacing, ' ');
-    printBorder(m_columns - 2, maxColumnWidth, spacing);
-    std::cout << std::string(maxColumnWidth + spacing, ' ');
-    std::cout << "|";
-    int half = (maxColumnWidth + spacing - 2) / 2;
-    for (int i = 0; i < m_columns; ++i)
-    {
-        std::cout << std::string(half, ' ') << "\033[33mB" << i + 1 << "\033[0m" << std::string(maxColumnWidth + spacing - 3 - half, ' ') << "|";
-    }
-    std::cout << std::endl;
-    printBorder(m_columns, maxColumnWidth, spacing);
-    for (int i = 0; i < m_rows; ++i)
-    {
-        std::cout << "|";
-        std::cout << std::string(half, ' ') << "\033[33mA" << i + 1 << "\033[0m" << std::string(maxColumnWidth + spacing - 3 - half, ' ') << "|";
-        for (int j = 0; j < m_columns; ++j)
-        {
-            std::cout << std::setw(maxColumnWidth + spacing - 1) << std::right << cost[i][j] << "|";
-        }
-        std::cout << "\033[33m" << std::setw(maxColumnWidth + spacing - 1) << std::right << suppliers[i] << "\033[0m|" << std::endl;
-        std::cout << "|" << std::string(maxColumnWidth + spacing - 1, ' ') << "|";
-        for (int j = 0; j < m_columns; ++j)
-        {
-            if (count[i][j] != -1)
-                std::cout << "\033[32m" << std::setw(maxColumnWidth + spacing - 1) << std::right << count[i][j] << "\033[0m|";
-            else
-                std::cout << std::string(maxColumnWidth + spacing - 1, ' ') << "|";
-        }
-        std::cout << std::string(maxColumnWidth + spacing - 1, ' ') << "|" << std::endl;
-        printBorder(m_columns, maxColumnWidth, spacing);
-    }
-    std::cout << std::string(maxColumnWidth + spacing, ' ') << "|";
-    for (int i = 0; i < m_columns; ++i)
-    {
-        std::cout << "\033[33m" << std::setw(maxColumnWidth + spacing - 1) << std::right << consumers[i] << "\033[0m|";
-    }
-    std::cout << std::endl
-              << std::string(maxColumnWidth + spacing, ' ');
-    printBorder(m_columns - 2, maxColumnWidth, spacing);
-    std::cout << std::endl;
-}
-
-void Matrix::print(std::vector<unsigned long long>& currentSupplier, std::vector<unsigned long long>& currentConsumer) const
-{
-    int spacing = 9;
-
-    auto printBorder = [](int m_columns, int maxColumnWidth, int spacing) -> void
-    {
-        for (int i = 0; i <= m_columns + 1; ++i)
-        {
-            std::cout << "+" << std::string((maxColumnWidth + spacing - 1), '-');
-        }
-        std::cout << "+" << std::endl;
-    };
-    std::cout << std::string(maxColumnWidth + spacing, ' ');
-    printBorder(m_columns - 2, maxColumnWidth, spacing);
-    std::cout << std::string(maxColumnWidth + spacing, ' ');
-    std::cout << "|";
-    int half = (maxColumnWidth + spacing - 2) / 2;
-    for (int i = 0; i < m_columns; ++i)
+    if (argc < 2)
     {
-        std::cout << std::string(half, ' ') << "\033[33mB" << i + 1 << "\033[0m" << std::string(maxColumnWidth + spacing - 3 - half, ' ') << "|";
+        std::cerr << "./main <filename>" << std::endl;
+        exit(EXIT_FAILURE);
     }
-    std::cout << std::endl;
-    printBorder(m_columns, maxColumnWidth, spacing);
-    for (int i = 0; i < m_rows; ++i)
-    {
-        std::cout << "|";
-        std::cout << std::string(half, ' ') << "\033[33mA" << i + 1 << "\033[0m" << std::string(maxColumnWidth + spacing - 3 - half, ' ') << "|";
-        for (int j = 0; j < m_columns; ++j)
+    std::ifstream in(argv[1]);
+    transport::Matrix matrix(in);
+    matrix.setOutput(&std::cout);
+    transport::Solution solution(std::move(matrix));
+    std::string saveTo, stats, checkpoint, resume;
+    double every = 5;
+    Budget budget;
+    for (int i = 2; i < argc; i += 2)
+    {
+        std::string arg = argv[i];
+        bool valid = i + 1 < argc;
+        if (valid && arg == "--initial")
+            valid = solution.setMethod(argv[i + 1]);
+        else if (valid && arg == "--engine")
+            valid = solution.setEngine(argv[i + 1]);
+        else if (valid && arg == "--objective")
+            valid = solution.setObjective(argv[i + 1]);
+        else if (valid && arg == "--threads")
+            solution.setThreads(std::atoi(argv[i + 1]));
+        else if (valid && arg == "--basis")
         {
-            std::cout << std::setw(maxColumnWidth + spacing - 1) << std::right << cost[i][j] << "|";
+            std::ifstream basis(argv[i + 1]);
+            valid = solution.loadBasis(basis);
         }
-        if (currentSupplier[i] != suppliers[i]) std::cout << "\033[32m" << std::setw(maxColumnWidth + spacing - 1) << std::right << suppliers[i] << "\033[0m|" << std::endl;
-        else std::cout << "\033[31m" << std::setw(maxColumnWidth + spacing - 1) << std::right << suppliers[i] << "\033[0m|" << std::endl;
-        std::cout << "|" << std::string(maxColumnWidth + spacing - 1, ' ') << "|";
-        for (int j = 0; j < m_columns; ++j)
+        else if (valid && arg == "--save-basis")
+            saveTo = argv[i + 1];
+        else if (valid && arg == "--time-limit")
+            budget.seconds = std::atof(argv[i + 1]);
+        else if (valid && arg == "--step-limit")
+            budget.steps = std::atoll(argv[i + 1]);
+        else if (valid && arg == "--checkpoint")
+            checkpoint = argv[i + 1];
+        else if (valid && arg == "--checkpoint-every")
+            valid = (every = std::atof(argv[i + 1])) > 0;
+        else if (valid && arg == "--resume")
+            resume = argv[i + 1];
+        else if (valid && arg == "--stats")
         {
-            if (count[i][j] != -1)
-                std::cout << "\033[32m" << std::setw(maxColumnWidth + spacing - 1) << std::right << count[i][j] << "\033[0m|";
-            else
-                std::cout << std::string(maxColumnWidth + spacing - 1, ' ') << "|";
+            stats = argv[i + 1];
+            valid = stats == "text" || stats == "json";
         }
-        std::cout << std::string(maxColumnWidth + spacing - 1, ' ') << "|" << std::endl;
-        printBorder(m_columns, maxColumnWidth, spacing);
-    }
-    std::cout << std::string(maxColumnWidth + spacing, ' ') << "|";
-    for (int i = 0; i < m_columns; ++i)
-    {
-        if (currentConsumer[i] != consumers[i]) std::cout << "\033[32m" << std::setw(maxColumnWidth + spacing - 1) << std::right << consumers[i] << "\033[0m|";
-        else std::cout << "\033[31m" << std::setw(maxColumnWidth + spacing - 1) << std::right << consumers[i] << "\033[0m|";
-    }
-    std::cout << std::endl
-              << std::string(maxColumnWidth + spacing, ' ');
-    printBorder(m_columns - 2, maxColumnWidth, spacing);
-    std::cout << std::endl;
-}
-
-int Matrix::makeClose()
-{
-    unsigned long long suppliersCount = std::accumulate(suppliers.begin(), suppliers.end(), 0);
-    unsigned long long consumersCount = std::accumulate(consumers.begin(), consumers.end(), 0);
-    if (suppliersCount == consumersCount)
-    {
-        std::cout << "The model of the transport task is closed!" << std::endl;
-        return 0;
-    }
-    std::cout << "The model of the transport task is open! Make close model:" << std::endl;
-    if (suppliersCount > consumersCount)
-    {
-        consumers.push_back(suppliersCount - consumersCount);
-        for (int i = 0; i < m_rows; ++i)
+        else
+            valid = false;
+        if (!valid)
         {
-            cost[i].push_back(0);
-            count[i].push_back(-1);
+            std::cerr << "./main <filename> [--initial min|vogel|russell] [--engine auto|modi|network|scaling|auction] [--objective cost|bottleneck] [--threads N]"
+                      << " [--basis file] [--save-basis file] [--time-limit seconds] [--step-limit iterations]"
+                      << " [--checkpoint file] [--checkpoint-every seconds] [--resume file] [--stats text|json]" << std::endl;
+            exit(EXIT_FAILURE);
         }
-        m_columns++;
-        print();
-        return 1;
     }
-    suppliers.push_back(consumersCount - suppliersCount);
-    cost.push_back(std::vector<unsigned long long>(m_columns, 0));
-    count.push_back(std::vector<long long>(m_columns, -1));
-    m_rows++;
-    print();
-    return 2;
-}
-
-std::vector<std::pair<int, int>> Matrix::getSortedCoords() const
-{
-    std::vector<std::pair<unsigned long long, std::pair<int, int>>> vec;
-    for (int i = 0; i < m_rows; ++i)
+    if (!resume.empty())
     {
-        for (int j = 0; j < m_columns; ++j)
+        std::ifstream saved(resume, std::ios::binary);
+        if (!solution.resume(saved))
         {
-            vec.push_back({cost[i][j], {i, j}});
+            std::cerr << resume << " is not a checkpoint of this problem" << std::endl;
+            exit(EXIT_FAILURE);
         }
     }
-    std::sort(vec.begin(), vec.end());
-    std::vector<std::pair<int, int>> coords(vec.size());
-    for (int i = 0; i < vec.size(); ++i)
-    {
-        coords[i] = vec[i].second;
-    }
-    return coords;
-}
-
-void Matrix::printDistribution() const
-{
-    std::cout << "Expenses:" << std::endl;
-    unsigned long long resSum = 0;
-    for (int i = 0; i < m_rows; ++i)
+    solution.setCheckpoint(checkpoint, every);
+    budget.cancel = cancelOnInterrupt();
+    solution.setBudget(budget);
+    if (!stats.empty())
+        counters::start();
+    transport::Result result = solution.run();
+    if (!stats.empty())
+        counters::report(std::cout, stats, result.stats);
+    if (!saveTo.empty())
     {
-        unsigned long long rowSum = 0;
-        for (int j = 0; j < m_columns; ++j)
-        {
-            rowSum += std::max(0ll, count[i][j]) * cost[i][j];
-        }
-        resSum += rowSum;
-        std::cout << "\033[33mA" << i + 1 << "\033[0m = " << rowSum << std::endl;
+        std::ofstream out(saveTo);
+        solution.saveBasis(out);
     }
-    std::cout << std::endl;
-    std::cout << "\033[33mResult\033[0m = " << resSum << std::endl;
+    return EXIT_SUCCESS;
 }
 
-class Solution
+int main(int argc, char **argv)
 {
-private:
-    Matrix matrix;
-
-public:
-    Solution(Matrix matrix)
+    try
     {
-        this->matrix = matrix;
+        return run(argc, argv);
     }
-    void run();
-};
-
-void Solution::run()
-{
-    matrix.print();
-    std::vector<std::pair<int, int>> coords = matrix.getSortedCoords();
-    int opened = matrix.makeClose();
-    std::vector<unsigned long long> currentSuppliers(matrix.rows(), 0);
-    std::vector<unsigned long long> currentConsumers(matrix.columns(), 0);
-    int countOfSelected = 0;
-    for (const auto &[row, column] : coords)
+    catch (const std::exception &error)
     {
-        if (currentSuppliers[row] < matrix.supplierAt(row) && currentConsumers[column] < matrix.consumersAt(column) && countOfSelected < matrix.rows() + matrix.columns() - 1)
-        {
-            long long minimum = std::min(matrix.supplierAt(row) - currentSuppliers[row], matrix.consumersAt(column) - currentConsumers[column]);
-            matrix.setCountAt(row, column, minimum);
-            currentSuppliers[row] += minimum;
-            currentConsumers[column] += minimum;
-            countOfSelected++;
-            matrix.print(currentSuppliers, currentConsumers);
-            if (currentSuppliers[row] == matrix.supplierAt(row) && currentConsumers[column] == matrix.consumersAt(column))
-            {
-                bool flag = false;
-                for (int i = 0; i < matrix.rows(); ++i)
-                {
-                    if (currentSuppliers[i] != matrix.supplierAt(i))
-                    {
-                        std::cout << "Both Consumer and Supplier are closing, position to 0 is: (A" << i+1 << "; B" << column+1 << ")" << std::endl;
-                        matrix.setCountAt(i, column, 0);
-                        flag = true;
-                        countOfSelected++;
-                        matrix.print(currentSuppliers, currentConsumers);
-                        break;
-                    }
-                }
-                if (!flag)
-                {
-                    for (int i = 0; i < matrix.columns(); ++i)
-                    {
-                        if (currentConsumers[i] != matrix.consumersAt(i))
-                        {
-                            matrix.setCountAt(row, i, 0);
-                            flag = true;
-                            countOfSelected++;
-                            matrix.print(currentSuppliers, currentConsumers);
-                            break;
-                        }
-                    }
-                }
-            }
-        }
+        std::cerr << error.what() << std::endl;
+        return EXIT_FAILURE;
     }
-    if (opened == 1)
-    {
-        for (int i = 0; i < currentSuppliers.size(); ++i)
-        {
-            if (currentSuppliers[i] < matrix.supplierAt(i))
-            {
-                matrix.setCountAt(i, matrix.columns() - 1, matrix.supplierAt(i) - currentSuppliers[i]);
-                currentConsumers[matrix.columns() - 1] += matrix.supplierAt(i) - currentSuppliers[i];
-                currentSuppliers[i] = matrix.supplierAt(i);
-                countOfSelected++;
-            }
-        }
-        matrix.print(currentSuppliers, currentConsumers);
-    }
-    if (opened == 2)
-    {
-        for (int i = 0; i < currentConsumers.size(); ++i)
-        {
-            if (currentConsumers[i] < matrix.consumersAt(i))
-            {
-                matrix.setCountAt(matrix.rows() - 1, i, matrix.consumersAt(i) - currentConsumers[i]);
-                currentSuppliers[matrix.rows() - 1] += matrix.consumersAt(i) - currentConsumers[i];
-                currentConsumers[i] = matrix.consumersAt(i);
-                countOfSelected++;
-            }
-        }
-        matrix.print(currentSuppliers, currentConsumers);
-    }
-    if (countOfSelected < matrix.rows() + matrix.columns() - 1)
-    {
-        int ct = matrix.rows() + matrix.columns() - 1 - countOfSelected;
-        std::cout << "The plan is degenerate, it is necessary to add " << ct << " variables to the basis in:" << std::endl;
-        for (const auto &[row, column] : coords)
-        {
-            if (matrix.countAt(row, column) == -1)
-            {
-                matrix.setCountAt(row, column, 0);
-                std::cout << "\033[33m(A" << row + 1 << "; B" << column + 1 << ")\033[0m" << std::endl;
-                ct--;
-                if (ct == 0)
-                {
-                    break;
-                }
-            }
-        }
-        matrix.print(currentSuppliers, currentConsumers);
-    }
-    matrix.printDistribution();
 }
-
-int main(int argc, char **argv)
-{
-    if (argc < 2)
-    {
-        std::cerr << "./main <filename>" << std::endl;
-        exit(EXIT_FAILURE);
-    }
-    std::ifstream in(argv[1]);
-    Matrix matrix(in);
-    Solution solution(matrix);
-    solution.run();
-    return EXIT_SUCCESS;
-}
\ No newline at end of file
@@ -0,0 +1,325 @@
+#include "network_simplex.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace transport
+{
+
+NetworkSimplex::NetworkSimplex(const Matrix &matrix) : matrix(matrix)
+{
+    m = matrix.rows();
+    n = matrix.columns();
+    nodes = m + n + 1;
+    root = m + n;
+    offset.assign(m + 1, 0);
+    long long maxCost = 0;
+    for (int i = 0; i < m; ++i)
+    {
+        offset[i + 1] = offset[i] + matrix.routeSize(i);
+        for (int k = 0; k < matrix.routeSize(i); ++k)
+        {
+            maxCost = std::max(maxCost, (long long)matrix.routeCost(i, k));
+        }
+    }
+    transportArcs = offset[m];
+    arcs = transportArcs + root;
+    blockSize = std::max(10ll, (long long)std::sqrt((double)arcs));
+
+    // Artificial arcs to the root are more expensive than any path through
+    // the real arcs, so all of them leave the basis of a feasible problem.
+    long long artificial = (maxCost + 1) * nodes;
+
+    treeFlow.assign(nodes, 0);
+    inTree.assign(arcs, false);
+    artificialCost.assign(root, artificial);
+    artificialUp.assign(root, true);
+    parent.assign(nodes, root);
+    depth.assign(nodes, 1);
+    thread.resize(nodes);
+    revThread.resize(nodes);
+    predArc.resize(nodes);
+    predUp.assign(nodes, true);
+    pi.assign(nodes, 0);
+    firstChild.assign(nodes, -1);
+    nextSibling.assign(nodes, -1);
+
+    // The initial tree is a star around the root. A node with nothing to
+    // ship hangs on an upward arc, so every zero-flow tree arc points to
+    // the root and the tree starts strongly feasible.
+    for (int v = 0; v < root; ++v)
+    {
+        long long supply = v < m ? (long long)matrix.supplierAt(v) : -(long long)matrix.consumersAt(v - m);
+        long long arc = transportArcs + v;
+        artificialUp[v] = supply >= 0;
+        predArc[v] = arc;
+        predUp[v] = artificialUp[v];
+        inTree[arc] = true;
+        treeFlow[v] = std::abs(supply);
+        pi[v] = artificialUp[v] ? -artificial : artificial;
+        thread[v] = v + 1;
+        revThread[v + 1] = v;
+    }
+    parent[root] = -1;
+    depth[root] = 0;
+    thread[root] = 0;
+    revThread[0] = root;
+    pi[root] = 0;
+}
+
+int NetworkSimplex::rowOf(long long arc) const
+{
+    return std::upper_bound(offset.begin(), offset.end(), arc) - offset.begin() - 1;
+}
+
+int NetworkSimplex::source(long long arc) const
+{
+    if (arc < transportArcs)
+        return rowOf(arc);
+    int v = arc - transportArcs;
+    return artificialUp[v] ? v : root;
+}
+
+int NetworkSimplex::target(long long arc) const
+{
+    if (arc < transportArcs)
+    {
+        int row = rowOf(arc);
+        return m + matrix.routeColumn(row, arc - offset[row]);
+    }
+    int v = arc - transportArcs;
+    return artificialUp[v] ? root : v;
+}
+
+long long NetworkSimplex::cost(long long arc) const
+{
+    if (arc < transportArcs)
+    {
+        int row = rowOf(arc);
+        return matrix.routeCost(row, arc - offset[row]);
+    }
+    return artificialCost[arc - transportArcs];
+}
+
+long long NetworkSimplex::reducedCost(long long arc) const
+{
+    return cost(arc) + pi[source(arc)] - pi[target(arc)];
+}
+
+// Block search: scan the arcs cyclically from where the previous search
+// stopped and take the most negative reduced cost of the first block that
+// has one. The scan follows the rows along, so a route needs no lookup.
+long long NetworkSimplex::findEntering()
+{
+    long long best = -1, minCost = 0, left = blockSize;
+    for (long long k = 0; k < arcs; ++k)
+    {
+        long long arc = nextArc;
+        nextArc = nextArc + 1 == arcs ? 0 : nextArc + 1;
+        if (arc == 0)
+            nextRow = 0;
+        while (arc < transportArcs && arc >= offset[nextRow + 1])
+        {
+            nextRow++;
+        }
+        if (!inTree[arc])
+        {
+            long long delta;
+            if (arc < transportArcs)
+            {
+                int index = arc - offset[nextRow];
+                delta = (long long)matrix.routeCost(nextRow, index) + pi[nextRow] - pi[m + matrix.routeColumn(nextRow, index)];
+            }
+            else
+                delta = reducedCost(arc);
+            if (delta < minCost)
+            {
+                minCost = delta;
+                best = arc;
+            }
+        }
+        if (--left == 0)
+        {
+            if (best != -1)
+                return best;
+            left = blockSize;
+        }
+    }
+    return best;
+}
+
+int NetworkSimplex::findJoin(int u, int v) const
+{
+    while (u != v)
+    {
+        if (depth[u] >= depth[v])
+            u = parent[u];
+        else
+            v = parent[v];
+    }
+    return u;
+}
+
+// The subtree below uOut is cut off, re-rooted at uIn and hung under vIn.
+// Only its nodes get new depths, potentials and a new place in the thread.
+void NetworkSimplex::updateTree(int uIn, int vIn, int uOut, long long entering, long long enteringFlow)
+{
+    int last = uOut;
+    while (thread[last] != root && depth[thread[last]] > depth[uOut])
+    {
+        last = thread[last];
+    }
+    int prev = revThread[uOut], next = thread[last];
+    thread[prev] = next;
+    revThread[next] = prev;
+    for (int x = uOut;; x = thread[x])
+    {
+        firstChild[x] = -1;
+        if (x == last)
+            break;
+    }
+
+    path.clear();
+    for (int x = uIn; x != uOut; x = parent[x])
+    {
+        path.push_back(x);
+    }
+    path.push_back(uOut);
+    for (int k = (int)path.size() - 2; k >= 0; --k)
+    {
+        int child = path[k + 1], node = path[k];
+        parent[child] = node;
+        predArc[child] = predArc[node];
+        predUp[child] = !predUp[node];
+        treeFlow[child] = treeFlow[node];
+    }
+    parent[uIn] = vIn;
+    predArc[uIn] = entering;
+    treeFlow[uIn] = enteringFlow;
+    predUp[uIn] = source(entering) == uIn;
+
+    int x = uOut;
+    while (true)
+    {
+        if (x != uIn)
+        {
+            nextSibling[x] = firstChild[parent[x]];
+            firstChild[parent[x]] = x;
+        }
+        if (x == last)
+            break;
+        x = thread[x];
+    }
+
+    order.clear();
+    stack.assign(1, uIn);
+    while (!stack.empty())
+    {
+        int node = stack.back();
+        stack.pop_back();
+        order.push_back(node);
+        long long arc = predArc[node];
+        depth[node] = depth[parent[node]] + 1;
+        pi[node] = predUp[node] ? pi[parent[node]] - cost(arc) : pi[parent[node]] + cost(arc);
+        for (int child = firstChild[node]; child != -1; child = nextSibling[child])
+        {
+            stack.push_back(child);
+        }
+    }
+
+    int after = thread[vIn];
+    int previous = vIn;
+    for (int node : order)
+    {
+        thread[previous] = node;
+        revThread[node] = previous;
+        previous = node;
+    }
+    thread[previous] = after;
+    revThread[after] = previous;
+}
+
+long long NetworkSimplex::run()
+{
+    long long pivots = 0;
+    while (true)
+    {
+        long long entering = findEntering();
+        if (entering == -1)
+            break;
+        int first = source(entering), second = target(entering);
+        int join = findJoin(first, second);
+
+        // The cycle runs join -> first -> second -> join. Ties go to the last
+        // blocking arc met from the join, which keeps the tree strongly
+        // feasible.
+        long long delta = std::numeric_limits<long long>::max();
+        int uOut = -1;
+        bool onFirst = true;
+        for (int u = first; u != join; u = parent[u])
+        {
+            if (predUp[u] && treeFlow[u] < delta)
+            {
+                delta = treeFlow[u];
+                uOut = u;
+            }
+        }
+        for (int u = second; u != join; u = parent[u])
+        {
+            if (!predUp[u] && treeFlow[u] <= delta)
+            {
+                delta = treeFlow[u];
+                uOut = u;
+                onFirst = false;
+            }
+        }
+        if (uOut == -1)
+            break;
+
+        if (delta > 0)
+        {
+            for (int u = first; u != join; u = parent[u])
+            {
+                treeFlow[u] += predUp[u] ? -delta : delta;
+            }
+            for (int u = second; u != join; u = parent[u])
+            {
+                treeFlow[u] += predUp[u] ? delta : -delta;
+            }
+        }
+        inTree[predArc[uOut]] = false;
+        inTree[entering] = true;
+        if (onFirst)
+            updateTree(first, second, uOut, entering, delta);
+        else
+            updateTree(second, first, uOut, entering, delta);
+        pivots++;
+    }
+    return pivots;
+}
+
+bool NetworkSimplex::feasible() const
+{
+    for (int v = 0; v < root; ++v)
+    {
+        if (predArc[v] >= transportArcs && treeFlow[v] != 0)
+            return false;
+    }
+    return true;
+}
+
+std::vector<std::tuple<int, int, long long>> NetworkSimplex::plan() const
+{
+    std::vector<std::tuple<int, int, long long>> result;
+    for (int v = 0; v < root; ++v)
+    {
+        if (predArc[v] < transportArcs)
+        {
+            int row = rowOf(predArc[v]);
+            result.push_back({row, (int)(predArc[v] - offset[row]), treeFlow[v]});
+        }
+    }
+    return result;
+}
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "transport.hpp"
+#include <tuple>
+#include <vector>
+
+namespace transport
+{
+
+// Primal network simplex on the routes of a closed transport Matrix. The basis is a spanning tree over the m + n
+// nodes plus an artificial root, stored as parent/depth/thread arrays. A
+// pivot only re-hangs the subtree cut off by the leaving arc, and only that
+// subtree gets new depths and potentials. Entering arcs come from block
+// search, and the leaving arc keeps the tree strongly feasible, so
+// degenerate pivots cannot cycle. Arcs off the tree carry no flow, so flow
+// is kept per node for the arc to its parent, and an arc costs one bit.
+class NetworkSimplex
+{
+private:
+    int m, n, nodes, root;
+    long long transportArcs, arcs;
+    long long blockSize, nextArc = 0;
+    int nextRow = 0;
+    const Matrix &matrix;
+    std::vector<long long> offset;
+    std::vector<long long> artificialCost;
+    std::vector<bool> artificialUp;
+    std::vector<long long> treeFlow;
+    std::vector<bool> inTree;
+    std::vector<int> parent, depth, thread, revThread;
+    std::vector<long long> predArc;
+    std::vector<bool> predUp;
+    std::vector<long long> pi;
+    std::vector<int> firstChild, nextSibling, path, stack, order;
+
+    int rowOf(long long arc) const;
+    int source(long long arc) const;
+    int target(long long arc) const;
+    long long cost(long long arc) const;
+    long long reducedCost(long long arc) const;
+    long long findEntering();
+    int findJoin(int u, int v) const;
+    void updateTree(int uIn, int vIn, int uOut, long long entering, long long enteringFlow);
+
+public:
+    NetworkSimplex(const Matrix &matrix);
+    long long run();
+    bool feasible() const;
+    // (row, index in matrix.routesOf(row), flow) of every route in the tree.
+    std::vector<std::tuple<int, int, long long>> plan() const;
+};
+
+}
@@ -0,0 +1,1764 @@
+#include "transport.hpp"
+#include "network_simplex.hpp"
+#include "cost_scaling.hpp"
+#include "auction.hpp"
+#include "bottleneck.hpp"
+#include "counters.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+
+namespace transport
+{
+
+Matrix::Matrix(std::istream &in)
+{
+    // A sparse table starts with "routes m n k" and lists its k permitted
+    // routes as "i j cost" lines (1-based) before the supplies and demands.
+    std::string word;
+    in >> word;
+    int count = 0;
+    if (word == "routes")
+    {
+        dense = false;
+        in >> m_rows >> m_columns >> count;
+    }
+    else
+    {
+        m_rows = std::atoi(word.c_str());
+        in >> m_columns;
+    }
+    suppliers.resize(m_rows);
+    consumers.resize(m_columns);
+    start.assign(m_rows + 1, 0);
+    unsigned long long maxValue = 0;
+    std::vector<std::pair<std::pair<int, int>, unsigned long long>> listed;
+    for (int k = 0; k < count; ++k)
+    {
+        int row, column;
+        unsigned long long cost;
+        in >> row >> column >> cost;
+        if (row < 1 || row > m_rows || column < 1 || column > m_columns)
+            throw std::invalid_argument("Unknown route (A" + std::to_string(row) + "; B" + std::to_string(column) + ")");
+        listed.push_back({{row - 1, column - 1}, cost});
+        maxValue = std::max(maxValue, cost);
+    }
+    std::sort(listed.begin(), listed.end());
+    for (const auto &[cell, cost] : listed)
+    {
+        start[cell.first + 1]++;
+        columnOf.push_back(cell.second);
+        pushCost(cost);
+    }
+    if (dense)
+        narrowCost.reserve((size_t)m_rows * m_columns);
+    for (int i = 0; i < m_rows; ++i)
+    {
+        for (int j = 0; dense && j < m_columns; ++j)
+        {
+            unsigned long long cost;
+            in >> cost;
+            pushCost(cost);
+            maxValue = std::max(maxValue, cost);
+        }
+        start[i + 1] = dense ? start[i] + m_columns : start[i] + start[i + 1];
+        in >> suppliers[i];
+        maxValue = std::max(maxValue, suppliers[i]);
+    }
+    for (int i = 0; i < m_columns; ++i)
+    {
+        in >> consumers[i];
+        maxValue = std::max(maxValue, consumers[i]);
+    }
+    maxColumnWidth = std::to_string(maxValue).size();
+    index();
+
+    // Optional transshipment extension:
+    //   transit <nodes> <arcs>
+    //   <from> <to> <cost>      e.g. A1 T2 4, T2 B3 1
+    if (in >> word && word == "transit")
+    {
+        in >> m_transit >> count;
+        for (int k = 0; k < count; ++k)
+        {
+            std::string from, to;
+            Arc arc;
+            in >> from >> to >> arc.cost;
+            arc.from = parseNode(from);
+            arc.to = parseNode(to);
+            arcs.push_back(arc);
+        }
+    }
+}
+
+int Matrix::parseNode(const std::string &name) const
+{
+    int index = name.size() > 1 ? std::atoi(name.c_str() + 1) - 1 : -1;
+    int limit = name[0] == 'A' ? m_rows : name[0] == 'B' ? m_columns : name[0] == 'T' ? m_transit : 0;
+    if (index < 0 || index >= limit)
+        throw std::invalid_argument("Unknown node " + name + " in the transit arcs");
+    return name[0] == 'A' ? index : name[0] == 'B' ? m_rows + index : m_rows + m_columns + index;
+}
+
+std::string Matrix::nodeName(int node) const
+{
+    if (node < m_rows)
+        return "A" + std::to_string(node + 1);
+    if (node < m_rows + m_columns)
+        return "B" + std::to_string(node - m_rows + 1);
+    return "T" + std::to_string(node - m_rows - m_columns + 1);
+}
+
+Matrix::Matrix(const std::vector<std::vector<unsigned long long>> &cost, const std::vector<unsigned long long> &suppliers,
+               const std::vector<unsigned long long> &consumers)
+    : suppliers(suppliers), consumers(consumers)
+{
+    m_rows = suppliers.size();
+    m_columns = consumers.size();
+    start.assign(m_rows + 1, 0);
+    narrowCost.reserve((size_t)m_rows * m_columns);
+    unsigned long long maxCost = 0;
+    for (int i = 0; i < m_rows; ++i)
+    {
+        for (int j = 0; j < m_columns; ++j)
+        {
+            pushCost(cost[i][j]);
+            maxCost = std::max(maxCost, cost[i][j]);
+        }
+        start[i + 1] = start[i] + m_columns;
+    }
+    maxColumnWidth = std::to_string(maxCost).size();
+    index();
+}
+
+// Costs are kept 32 bits wide until one does not fit; from then on the
+// whole table is 64 bits wide.
+void Matrix::pushCost(unsigned long long cost)
+{
+    if (!wide && cost > UINT32_MAX)
+    {
+        wideCost.assign(narrowCost.begin(), narrowCost.end());
+        std::vector<uint32_t>().swap(narrowCost);
+        wide = true;
+    }
+    if (wide)
+        wideCost.push_back(cost);
+    else
+        narrowCost.push_back(cost);
+}
+
+void Matrix::index()
+{
+    if (!dense)
+    {
+        incomingStart.assign(m_columns + 1, 0);
+        for (int column : columnOf)
+        {
+            incomingStart[column + 1]++;
+        }
+        for (int j = 0; j < m_columns; ++j)
+        {
+            incomingStart[j + 1] += incomingStart[j];
+        }
+        incoming.resize(columnOf.size());
+        std::vector<long long> fill(incomingStart.begin(), incomingStart.end() - 1);
+        for (int i = 0; i < m_rows; ++i)
+        {
+            for (int k = 0; k < storedRoutes(i); ++k)
+            {
+                incoming[fill[columnOf[start[i] + k]]++] = {i, k};
+            }
+        }
+    }
+    allocation.resize(m_rows);
+    layout();
+}
+
+// Every route gets a bit; the bits are laid out again from the allocation
+// lists whenever makeClose() changes the shape of the table.
+void Matrix::layout()
+{
+    slotStart.assign(m_rows + 1, 0);
+    for (int i = 0; i < m_rows; ++i)
+    {
+        slotStart[i + 1] = slotStart[i] + routeSize(i);
+    }
+    basic.assign((slotStart[m_rows] + 63) / 64, 0);
+    for (int i = 0; i < m_rows; ++i)
+    {
+        for (const auto &[index, count] : allocation[i])
+        {
+            long long slot = slotStart[i] + index;
+            basic[slot >> 6] |= 1ull << (slot & 63);
+        }
+    }
+}
+
+int Matrix::findRoute(int row, int column) const
+{
+    if (closingRow && row == m_rows - 1)
+        return column;
+    if (closingColumn && column == m_columns - 1)
+        return storedRoutes(row);
+    auto first = columnOf.begin() + start[row], last = columnOf.begin() + start[row + 1];
+    auto it = std::lower_bound(first, last, column);
+    return it != last && *it == column ? it - first : -1;
+}
+
+long long Matrix::routeCount(int row, int index) const
+{
+    if (!isBasic(slotStart[row] + index))
+        return -1;
+    for (const auto &[k, count] : allocation[row])
+    {
+        if (k == index)
+            return count;
+    }
+    return -1;
+}
+
+void Matrix::setRouteCount(int row, int index, long long count)
+{
+    long long slot = slotStart[row] + index;
+    auto &cells = allocation[row];
+    if (count == -1)
+    {
+        if (!isBasic(slot))
+            return;
+        basic[slot >> 6] &= ~(1ull << (slot & 63));
+        for (auto &cell : cells)
+        {
+            if (cell.first == index)
+            {
+                cell = cells.back();
+                cells.pop_back();
+                break;
+            }
+        }
+        return;
+    }
+    if (isBasic(slot))
+    {
+        for (auto &cell : cells)
+        {
+            if (cell.first == index)
+            {
+                cell.second = count;
+                return;
+            }
+        }
+    }
+    basic[slot >> 6] |= 1ull << (slot & 63);
+    cells.push_back({index, count});
+}
+
+void Matrix::clearCounts()
+{
+    std::fill(basic.begin(), basic.end(), 0);
+    for (auto &cells : allocation)
+    {
+        cells.clear();
+    }
+}
+
+int IncomingList::size() const
+{
+    if (matrix->closingColumn && column == matrix->m_columns - 1)
+        return matrix->m_rows;
+    if (matrix->dense)
+        return matrix->m_rows;
+    return matrix->incomingStart[column + 1] - matrix->incomingStart[column] + matrix->closingRow;
+}
+
+std::pair<int, int> IncomingList::operator[](int k) const
+{
+    if (matrix->closingColumn && column == matrix->m_columns - 1)
+        return {k, matrix->storedRoutes(k)};
+    if (matrix->dense)
+        return {k, column};
+    long long position = matrix->incomingStart[column] + k;
+    return position < matrix->incomingStart[column + 1] ? matrix->incoming[position] : std::make_pair(matrix->m_rows - 1, column);
+}
+
+std::ostream &Matrix::log() const
+{
+    thread_local std::ostream nullStream(nullptr);
+    return out ? *out : nullStream;
+}
+
+void Matrix::print() const
+{
+    if (!out)
+        return;
+    int spacing = 9;
+
+    auto printBorder = [this](int m_columns, int maxColumnWidth, int spacing) -> void
+    {
+        for (int i = 0; i <= m_columns + 1; ++i)
+        {
+            log() << "+" << std::string((maxColumnWidth + spacing - 1), '-');
+        }
+        log() << "+" << std::endl;
+    };
+    log() << std::string(maxColumnWidth + spacing, ' ');
+    printBorder(m_columns - 2, maxColumnWidth, spacing);
+    log() << std::string(maxColumnWidth + spacing, ' ');
+    log() << "|";
+    int half = (maxColumnWidth + spacing - 2) / 2;
+    for (int i = 0; i < m_columns; ++i)
+    {
+        log() << std::string(half, ' ') << "\033[33mB" << i + 1 << "\033[0m" << std::string(maxColumnWidth + spacing - 3 - half, ' ') << "|";
+    }
+    log() << std::endl;
+    printBorder(m_columns, maxColumnWidth, spacing);
+    for (int i = 0; i < m_rows; ++i)
+    {
+        log() << "|";
+        log() << std::string(half, ' ') << "\033[33mA" << i + 1 << "\033[0m" << std::string(maxColumnWidth + spacing - 3 - half, ' ') << "|";
+        for (int j = 0; j < m_columns; ++j)
+        {
+            int k = routeIndex(i, j);
+            if (k == -1)
+                log() << std::setw(maxColumnWidth + spacing - 1) << std::right << "-" << "|";
+            else
+                log() << std::setw(maxColumnWidth + spacing - 1) << std::right << routeCost(i, k) << "|";
+        }
+        log() << "\033[33m" << std::setw(maxColumnWidth + spacing - 1) << std::right << suppliers[i] << "\033[0m|" << std::endl;
+        log() << "|" << std::string(maxColumnWidth + spacing - 1, ' ') << "|";
+        for (int j = 0; j < m_columns; ++j)
+        {
+            if (countAt(i, j) != -1)
+                log() << "\033[32m" << std::setw(maxColumnWidth + spacing - 1) << std::right << countAt(i, j) << "\033[0m|";
+            else
+                log() << std::string(maxColumnWidth + spacing - 1, ' ') << "|";
+        }
+        log() << std::string(maxColumnWidth + spacing - 1, ' ') << "|" << std::endl;
+        printBorder(m_columns, maxColumnWidth, spacing);
+    }
+    log() << std::string(maxColumnWidth + spacing, ' ') << "|";
+    for (int i = 0; i < m_columns; ++i)
+    {
+        log() << "\033[33m" << std::setw(maxColumnWidth + spacing - 1) << std::right << consumers[i] << "\033[0m|";
+    }
+    log() << std::endl
+              << std::string(maxColumnWidth + spacing, ' ');
+    printBorder(m_columns - 2, maxColumnWidth, spacing);
+    log() << std::endl;
+}
+
+void Matrix::print(std::vector<unsigned long long>& currentSupplier, std::vector<unsigned long long>& currentConsumer) const
+{
+    if (!out)
+        return;
+    int spacing = 9;
+
+    auto printBorder = [this](int m_columns, int maxColumnWidth, int spacing) -> void
+    {
+        for (int i = 0; i <= m_columns + 1; ++i)
+        {
+            log() << "+" << std::string((maxColumnWidth + spacing - 1), '-');
+        }
+        log() << "+" << std::endl;
+    };
+    log() << std::string(maxColumnWidth + spacing, ' ');
+    printBorder(m_columns - 2, maxColumnWidth, spacing);
+    log() << std::string(maxColumnWidth + spacing, ' ');
+    log() << "|";
+    int half = (maxColumnWidth + spacing - 2) / 2;
+    for (int i = 0; i < m_columns; ++i)
+    {
+        log() << std::string(half, ' ') << "\033[33mB" << i + 1 << "\033[0m" << std::string(maxColumnWidth + spacing - 3 - half, ' ') << "|";
+    }
+    log() << std::endl;
+    printBorder(m_columns, maxColumnWidth, spacing);
+    for (int i = 0; i < m_rows; ++i)
+    {
+        log() << "|";
+        log() << std::string(half, ' ') << "\033[33mA" << i + 1 << "\033[0m" << std::string(maxColumnWidth + spacing - 3 - half, ' ') << "|";
+        for (int j = 0; j < m_columns; ++j)
+        {
+            int k = routeIndex(i, j);
+            if (k == -1)
+                log() << std::setw(maxColumnWidth + spacing - 1) << std::right << "-" << "|";
+            else
+                log() << std::setw(maxColumnWidth + spacing - 1) << std::right << routeCost(i, k) << "|";
+        }
+        if (currentSupplier[i] != suppliers[i]) log() << "\033[32m" << std::setw(maxColumnWidth + spacing - 1) << std::right << suppliers[i] << "\033[0m|" << std::endl;
+        else log() << "\033[31m" << std::setw(maxColumnWidth + spacing - 1) << std::right << suppliers[i] << "\033[0m|" << std::endl;
+        log() << "|" << std::string(maxColumnWidth + spacing - 1, ' ') << "|";
+        for (int j = 0; j < m_columns; ++j)
+        {
+            if (countAt(i, j) != -1)
+                log() << "\033[32m" << std::setw(maxColumnWidth + spacing - 1) << std::right << countAt(i, j) << "\033[0m|";
+            else
+                log() << std::string(maxColumnWidth + spacing - 1, ' ') << "|";
+        }
+        log() << std::string(maxColumnWidth + spacing - 1, ' ') << "|" << std::endl;
+        printBorder(m_columns, maxColumnWidth, spacing);
+    }
+    log() << std::string(maxColumnWidth + spacing, ' ') << "|";
+    for (int i = 0; i < m_columns; ++i)
+    {
+        if (currentConsumer[i] != consumers[i]) log() << "\033[32m" << std::setw(maxColumnWidth + spacing - 1) << std::right << consumers[i] << "\033[0m|";
+        else log() << "\033[31m" << std::setw(maxColumnWidth + spacing - 1) << std::right << consumers[i] << "\033[0m|";
+    }
+    log() << std::endl
+              << std::string(maxColumnWidth + spacing, ' ');
+    printBorder(m_columns - 2, maxColumnWidth, spacing);
+    log() << std::endl;
+}
+
+int Matrix::makeClose()
+{
+    unsigned long long suppliersCount = std::accumulate(suppliers.begin(), suppliers.end(), 0ull);
+    unsigned long long consumersCount = std::accumulate(consumers.begin(), consumers.end(), 0ull);
+    if (suppliersCount == consumersCount)
+    {
+        log() << "The model of the transport task is closed!" << std::endl;
+        return 0;
+    }
+    log() << "The model of the transport task is open! Make close model:" << std::endl;
+    if (suppliersCount > consumersCount)
+    {
+        consumers.push_back(suppliersCount - consumersCount);
+        closingColumn = true;
+        m_columns++;
+        layout();
+        print();
+        return 1;
+    }
+    suppliers.push_back(consumersCount - suppliersCount);
+    closingRow = true;
+    m_rows++;
+    allocation.resize(m_rows);
+    layout();
+    print();
+    return 2;
+}
+
+CellOrder::CellOrder(const Matrix &matrix, int rows, int columns)
+    : matrix(matrix), offset(rows + 1, 0), size(rows, 0), rowOpen(rows, true), columnOpen(columns, true)
+{
+    for (int i = 0; i < rows; ++i)
+    {
+        for (uint32_t k = 0; k < matrix.routeSize(i) && matrix.routeColumn(i, k) < columns; ++k)
+        {
+            cells.push_back(k);
+        }
+        offset[i + 1] = cells.size();
+        size[i] = offset[i + 1] - offset[i];
+        std::make_heap(cells.begin() + offset[i], cells.end(), [this, i](uint32_t a, uint32_t b)
+                       { return cellGreater(i, a, b); });
+        if (size[i] > 0)
+            rowHeap.push_back(i);
+    }
+    std::make_heap(rowHeap.begin(), rowHeap.end(), [this](uint32_t a, uint32_t b)
+                   { return rowGreater(a, b); });
+}
+
+bool CellOrder::cellGreater(int row, uint32_t a, uint32_t b) const
+{
+    unsigned long long x = matrix.routeCost(row, a), y = matrix.routeCost(row, b);
+    return x != y ? x > y : a > b;
+}
+
+bool CellOrder::rowGreater(uint32_t a, uint32_t b) const
+{
+    unsigned long long x = matrix.routeCost(a, cells[offset[a]]), y = matrix.routeCost(b, cells[offset[b]]);
+    return x != y ? x > y : a > b;
+}
+
+bool CellOrder::next(int &row, int &column)
+{
+    auto rowCompare = [this](uint32_t a, uint32_t b)
+    { return rowGreater(a, b); };
+    while (!rowHeap.empty())
+    {
+        std::pop_heap(rowHeap.begin(), rowHeap.end(), rowCompare);
+        int i = rowHeap.back();
+        rowHeap.pop_back();
+        if (!rowOpen[i])
+            continue;
+
+        auto first = cells.begin() + offset[i];
+        auto cellCompare = [this, i](uint32_t a, uint32_t b)
+        { return cellGreater(i, a, b); };
+        auto pop = [&]()
+        {
+            std::pop_heap(first, first + size[i], cellCompare);
+            size[i]--;
+        };
+        bool skipped = false;
+        while (size[i] > 0 && !columnOpen[matrix.routeColumn(i, *first)])
+        {
+            pop();
+            skipped = true;
+        }
+        if (size[i] == 0)
+            continue;
+        // The row's key went up, so it has to compete with the others again.
+        if (skipped)
+        {
+            rowHeap.push_back(i);
+            std::push_heap(rowHeap.begin(), rowHeap.end(), rowCompare);
+            continue;
+        }
+        row = i;
+        column = matrix.routeColumn(i, *first);
+        pop();
+        if (size[i] > 0)
+        {
+            rowHeap.push_back(i);
+            std::push_heap(rowHeap.begin(), rowHeap.end(), rowCompare);
+        }
+        return true;
+    }
+    return false;
+}
+
+unsigned long long Matrix::totalCost() const
+{
+    unsigned long long resSum = 0;
+    for (int i = 0; i < m_rows; ++i)
+    {
+        for (const auto &[index, count] : allocation[i])
+        {
+            resSum += (unsigned long long)std::max(0ll, count) * routeCost(i, index);
+        }
+    }
+    for (const auto &arc : arcs)
+    {
+        resSum += arc.count * arc.cost;
+    }
+    return resSum;
+}
+
+void Matrix::printDistribution() const
+{
+    if (!out)
+        return;
+    log() << "Expenses:" << std::endl;
+    unsigned long long resSum = 0;
+    for (int i = 0; i < m_rows; ++i)
+    {
+        unsigned long long rowSum = 0;
+        for (const auto &[index, count] : allocation[i])
+        {
+            rowSum += (unsigned long long)std::max(0ll, count) * routeCost(i, index);
+        }
+        resSum += rowSum;
+        log() << "\033[33mA" << i + 1 << "\033[0m = " << rowSum << std::endl;
+    }
+    for (const auto &arc : arcs)
+    {
+        if (arc.count == 0)
+            continue;
+        resSum += arc.count * arc.cost;
+        log() << "\033[33m" << nodeName(arc.from) << " -> " << nodeName(arc.to) << "\033[0m = " << arc.count << " * " << arc.cost
+              << " = " << arc.count * arc.cost << std::endl;
+    }
+    log() << std::endl;
+    log() << "\033[33mResult\033[0m = " << resSum << std::endl;
+}
+
+// The method of potentials needs the basic cells (count != -1) to form a
+// spanning tree of the m + n supplier/consumer nodes. Cells with positive
+// flow always do; zero cells added for a degenerate plan may close a cycle
+// instead of joining two parts, so they are re-chosen cheapest first.
+bool Solution::makeTree()
+{
+    int nodes = matrix.rows() + matrix.columns();
+    std::vector<int> parent(nodes);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](int x)
+    {
+        while (parent[x] != x)
+        {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    };
+    auto unite = [&](int row, int column)
+    {
+        int a = find(row), b = find(matrix.rows() + column);
+        if (a == b)
+            return false;
+        parent[a] = b;
+        return true;
+    };
+
+    bool changed = false;
+    int ct = 0;
+    std::vector<std::pair<unsigned long long, std::pair<int, int>>> zeros;
+    for (int i = 0; i < matrix.rows(); ++i)
+    {
+        for (const auto &route : matrix.routesOf(i))
+        {
+            if (route.count > 0)
+            {
+                unite(i, route.column);
+                ct++;
+            }
+            else if (route.count == 0)
+                zeros.push_back({route.cost, {i, route.column}});
+        }
+    }
+    std::sort(zeros.begin(), zeros.end());
+    for (const auto &[cost, cell] : zeros)
+    {
+        if (unite(cell.first, cell.second))
+            ct++;
+        else
+        {
+            matrix.setCountAt(cell.first, cell.second, -1);
+            changed = true;
+        }
+    }
+    CellOrder order(matrix, matrix.rows(), matrix.columns());
+    int row, column;
+    while (ct < nodes - 1 && order.next(row, column))
+    {
+        if (matrix.countAt(row, column) == -1 && unite(row, column))
+        {
+            matrix.setCountAt(row, column, 0);
+            ct++;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+void Solution::calcPotentials(std::vector<long long> &u, std::vector<long long> &v) const
+{
+    u.assign(matrix.rows(), 0);
+    v.assign(matrix.columns(), 0);
+    std::vector<bool> rowDone(matrix.rows(), false), columnDone(matrix.columns(), false);
+    std::vector<int> queue;
+    for (int start = 0; start < matrix.rows(); ++start)
+    {
+        if (rowDone[start])
+            continue;
+        rowDone[start] = true;
+        queue.assign(1, start);
+        for (int k = 0; k < queue.size(); ++k)
+        {
+            int node = queue[k];
+            if (node < matrix.rows())
+            {
+                for (const auto &route : matrix.routesOf(node))
+                {
+                    if (!columnDone[route.column] && route.count != -1)
+                    {
+                        v[route.column] = (long long)route.cost - u[node];
+                        columnDone[route.column] = true;
+                        queue.push_back(matrix.rows() + route.column);
+                    }
+                }
+            }
+            else
+            {
+                int column = node - matrix.rows();
+                for (const auto &[i, index] : matrix.routesTo(column))
+                {
+                    const Route &route = matrix.routesOf(i)[index];
+                    if (!rowDone[i] && route.count != -1)
+                    {
+                        u[i] = (long long)route.cost - v[column];
+                        rowDone[i] = true;
+                        queue.push_back(i);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Returns the cycle closed by the non-basic cell (row, column): the cell
+// itself first, then the tree path back to it, so even positions get +theta
+// and odd positions -theta.
+std::vector<std::pair<int, int>> Solution::findCycle(int row, int column) const
+{
+    int rows = matrix.rows();
+    std::vector<int> from(rows + matrix.columns(), -1);
+    std::vector<int> queue = {rows + column};
+    from[rows + column] = rows + column;
+    for (int k = 0; k < queue.size() && from[row] == -1; ++k)
+    {
+        int node = queue[k];
+        if (node < rows)
+        {
+            for (const auto &route : matrix.routesOf(node))
+            {
+                if (from[rows + route.column] == -1 && route.count != -1)
+                {
+                    from[rows + route.column] = node;
+                    queue.push_back(rows + route.column);
+                }
+            }
+        }
+        else
+        {
+            for (const auto &[i, index] : matrix.routesTo(node - rows))
+            {
+                if (from[i] == -1 && matrix.routesOf(i)[index].count != -1)
+                {
+                    from[i] = node;
+                    queue.push_back(i);
+                }
+            }
+        }
+    }
+    std::vector<std::pair<int, int>> cycle = {{row, column}};
+    for (int node = row; node != rows + column; node = from[node])
+    {
+        int next = from[node];
+        if (node < rows)
+            cycle.push_back({node, next - rows});
+        else
+            cycle.push_back({next, node - rows});
+    }
+    return cycle;
+}
+
+long long Solution::optimize(Deadline &deadline)
+{
+    ALGOM_PHASE("optimize");
+    if (makeTree())
+    {
+        matrix.log() << "The zero cells of the degenerate plan are moved so that the basis is a tree:" << std::endl;
+        matrix.print();
+    }
+    std::vector<long long> u, v;
+    long long iteration = 0;
+    while (true)
+    {
+        calcPotentials(u, v);
+        matrix.log() << "Potentials: ";
+        for (int i = 0; i < matrix.rows(); ++i)
+        {
+            matrix.log() << "\033[33mu" << i + 1 << "\033[0m = " << u[i] << "; ";
+        }
+        for (int j = 0; j < matrix.columns(); ++j)
+        {
+            matrix.log() << "\033[33mv" << j + 1 << "\033[0m = " << v[j] << (j + 1 < matrix.columns() ? "; " : "");
+        }
+        matrix.log() << std::endl;
+
+        long long mmin = 0;
+        int row = -1, column = -1;
+        for (int i = 0; i < matrix.rows(); ++i)
+        {
+            for (const auto &route : matrix.routesOf(i))
+            {
+                if (route.count != -1)
+                    continue;
+                long long delta = (long long)route.cost - u[i] - v[route.column];
+                if (delta < mmin)
+                {
+                    mmin = delta;
+                    row = i;
+                    column = route.column;
+                }
+            }
+        }
+        if (row == -1)
+        {
+            matrix.log() << "All estimates are non-negative, the plan is optimal: Z = " << matrix.totalCost() << std::endl
+                         << std::endl;
+            break;
+        }
+        if (iteration > 0 && deadline.exhausted())
+        {
+            paused = true;
+            if (snapshots.enabled())
+                saveCheckpoint();
+            matrix.log() << "\033[33mStopped by the budget after " << iteration << " iterations, run() resumes from here\033[0m" << std::endl
+                         << "The plan is feasible but not proven optimal: Z = " << matrix.totalCost() << std::endl
+                         << std::endl;
+            break;
+        }
+        if (snapshots.due())
+            saveCheckpoint();
+
+        std::vector<std::pair<int, int>> cycle = findCycle(row, column);
+        long long theta = -1;
+        int leaving = -1;
+        for (int k = 1; k < cycle.size(); k += 2)
+        {
+            long long count = matrix.countAt(cycle[k].first, cycle[k].second);
+            if (theta == -1 || count < theta)
+            {
+                theta = count;
+                leaving = k;
+            }
+        }
+        iteration++;
+        matrix.log() << "Iteration " << iteration << ": estimate of \033[31m(A" << row + 1 << "; B" << column + 1 << ")\033[0m = " << mmin << ", cycle:";
+        for (int k = 0; k < cycle.size(); ++k)
+        {
+            matrix.log() << " " << (k % 2 ? "-" : "+") << "(A" << cycle[k].first + 1 << "; B" << cycle[k].second + 1 << ")";
+        }
+        matrix.log() << ", theta = " << theta << std::endl;
+        matrix.setCountAt(row, column, 0);
+        for (int k = 0; k < cycle.size(); ++k)
+        {
+            long long count = matrix.countAt(cycle[k].first, cycle[k].second);
+            matrix.setCountAt(cycle[k].first, cycle[k].second, k % 2 ? count - theta : count + theta);
+        }
+        matrix.setCountAt(cycle[leaving].first, cycle[leaving].second, -1);
+        matrix.print();
+        matrix.log() << "Z = " << matrix.totalCost() << std::endl
+                     << std::endl;
+    }
+    return iteration;
+}
+
+int Solution::initialMinimalCost(CellOrder &order, int opened,
+                                 std::vector<unsigned long long> &currentSuppliers, std::vector<unsigned long long> &currentConsumers)
+{
+    ALGOM_PHASE("initial plan");
+    int countOfSelected = 0;
+    int row, column;
+    while (countOfSelected < matrix.rows() + matrix.columns() - 1 && order.next(row, column))
+    {
+        if (currentSuppliers[row] < matrix.supplierAt(row) && currentConsumers[column] < matrix.consumersAt(column))
+        {
+            long long minimum = std::min(matrix.supplierAt(row) - currentSuppliers[row], matrix.consumersAt(column) - currentConsumers[column]);
+            matrix.setCountAt(row, column, minimum);
+            currentSuppliers[row] += minimum;
+            currentConsumers[column] += minimum;
+            countOfSelected++;
+            matrix.print(currentSuppliers, currentConsumers);
+            if (currentSuppliers[row] == matrix.supplierAt(row))
+                order.closeRow(row);
+            if (currentConsumers[column] == matrix.consumersAt(column))
+                order.closeColumn(column);
+            if (currentSuppliers[row] == matrix.supplierAt(row) && currentConsumers[column] == matrix.consumersAt(column))
+            {
+                bool flag = false;
+                for (const auto &[i, index] : matrix.routesTo(column))
+                {
+                    if (currentSuppliers[i] != matrix.supplierAt(i))
+                    {
+                        matrix.log() << "Both Consumer and Supplier are closing, position to 0 is: (A" << i+1 << "; B" << column+1 << ")" << std::endl;
+                        matrix.setCountAt(i, column, 0);
+                        flag = true;
+                        countOfSelected++;
+                        matrix.print(currentSuppliers, currentConsumers);
+                        break;
+                    }
+                }
+                if (!flag)
+                {
+                    for (const auto &route : matrix.routesOf(row))
+                    {
+                        int i = route.column;
+                        if (currentConsumers[i] != matrix.consumersAt(i))
+                        {
+                            matrix.setCountAt(row, i, 0);
+                            flag = true;
+                            countOfSelected++;
+                            matrix.print(currentSuppliers, currentConsumers);
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    if (opened == 1)
+    {
+        for (int i = 0; i < currentSuppliers.size(); ++i)
+        {
+            if (currentSuppliers[i] < matrix.supplierAt(i))
+            {
+                matrix.setCountAt(i, matrix.columns() - 1, matrix.supplierAt(i) - currentSuppliers[i]);
+                currentConsumers[matrix.columns() - 1] += matrix.supplierAt(i) - currentSuppliers[i];
+                currentSuppliers[i] = matrix.supplierAt(i);
+                countOfSelected++;
+            }
+        }
+        matrix.print(currentSuppliers, currentConsumers);
+    }
+    if (opened == 2)
+    {
+        for (int i = 0; i < currentConsumers.size(); ++i)
+        {
+            if (currentConsumers[i] < matrix.consumersAt(i))
+            {
+                matrix.setCountAt(matrix.rows() - 1, i, matrix.consumersAt(i) - currentConsumers[i]);
+                currentSuppliers[matrix.rows() - 1] += matrix.consumersAt(i) - currentConsumers[i];
+                currentConsumers[i] = matrix.consumersAt(i);
+                countOfSelected++;
+            }
+        }
+        matrix.print(currentSuppliers, currentConsumers);
+    }
+    return countOfSelected;
+}
+
+// Puts as much as possible into (row, column) and says which lines close:
+// 1 - the supplier, 2 - the consumer, 3 - both. When both run out at once
+// only one of them is crossed out while others of its kind are still open,
+// so a later zero allocation keeps m + n - 1 basic cells.
+int Solution::allocate(int row, int column, std::vector<unsigned long long> &currentSuppliers,
+                       std::vector<unsigned long long> &currentConsumers, int openRows, int openColumns)
+{
+    unsigned long long minimum = std::min(matrix.supplierAt(row) - currentSuppliers[row], matrix.consumersAt(column) - currentConsumers[column]);
+    matrix.setCountAt(row, column, minimum);
+    currentSuppliers[row] += minimum;
+    currentConsumers[column] += minimum;
+    matrix.print(currentSuppliers, currentConsumers);
+    bool supplierDone = currentSuppliers[row] == matrix.supplierAt(row);
+    bool consumerDone = currentConsumers[column] == matrix.consumersAt(column);
+    if (supplierDone && consumerDone)
+    {
+        if (openRows > 1)
+            return 1;
+        if (openColumns > 1)
+            return 2;
+        return 3;
+    }
+    return supplierDone ? 1 : 2;
+}
+
+// Vogel's approximation. Every line keeps its cells sorted by cost and two
+// cursors on its cheapest and second cheapest open cell; cursors only move
+// forward as lines close, so a step costs O(m + n) instead of O(mn).
+int Solution::initialVogel(std::vector<unsigned long long> &currentSuppliers, std::vector<unsigned long long> &currentConsumers)
+{
+    ALGOM_PHASE("initial plan");
+    int rows = matrix.rows(), columns = matrix.columns();
+    std::vector<std::vector<int>> rowOrder(rows), columnOrder(columns);
+    for (int i = 0; i < rows; ++i)
+    {
+        for (const auto &route : matrix.routesOf(i))
+        {
+            rowOrder[i].push_back(route.column);
+        }
+        std::stable_sort(rowOrder[i].begin(), rowOrder[i].end(), [&](int a, int b)
+                         { return matrix.costAt(i, a) < matrix.costAt(i, b); });
+    }
+    for (int j = 0; j < columns; ++j)
+    {
+        for (const auto &[i, index] : matrix.routesTo(j))
+        {
+            columnOrder[j].push_back(i);
+        }
+        std::stable_sort(columnOrder[j].begin(), columnOrder[j].end(), [&](int a, int b)
+                         { return matrix.costAt(a, j) < matrix.costAt(b, j); });
+    }
+    std::vector<bool> rowOpen(rows, true), columnOpen(columns, true);
+    std::vector<int> rowFirst(rows, 0), rowSecond(rows, 1), columnFirst(columns, 0), columnSecond(columns, 1);
+    int openRows = rows, openColumns = columns;
+    auto advance = [](const std::vector<int> &order, const std::vector<bool> &open, int &first, int &second)
+    {
+        while (first < order.size() && !open[order[first]])
+            ++first;
+        second = std::max(second, first + 1);
+        while (second < order.size() && !open[order[second]])
+            ++second;
+    };
+
+    int countOfSelected = 0;
+    while (openRows > 0 && openColumns > 0)
+    {
+        long long bestPenalty = -1;
+        unsigned long long bestCost = 0;
+        int row = -1, column = -1;
+        auto consider = [&](long long penalty, unsigned long long cost, int i, int j)
+        {
+            if (penalty > bestPenalty || (penalty == bestPenalty && cost < bestCost))
+            {
+                bestPenalty = penalty;
+                bestCost = cost;
+                row = i;
+                column = j;
+            }
+        };
+        if (matrix.logging())
+            matrix.log() << "Penalties:";
+        for (int i = 0; i < rows; ++i)
+        {
+            if (!rowOpen[i])
+                continue;
+            advance(rowOrder[i], columnOpen, rowFirst[i], rowSecond[i]);
+            if (rowFirst[i] == rowOrder[i].size())
+                continue;
+            unsigned long long first = matrix.costAt(i, rowOrder[i][rowFirst[i]]);
+            long long penalty = rowSecond[i] < rowOrder[i].size() ? matrix.costAt(i, rowOrder[i][rowSecond[i]]) - first : first;
+            if (matrix.logging())
+                matrix.log() << " A" << i + 1 << " = " << penalty << ";";
+            consider(penalty, first, i, rowOrder[i][rowFirst[i]]);
+        }
+        for (int j = 0; j < columns; ++j)
+        {
+            if (!columnOpen[j])
+                continue;
+            advance(columnOrder[j], rowOpen, columnFirst[j], columnSecond[j]);
+            if (columnFirst[j] == columnOrder[j].size())
+                continue;
+            unsigned long long first = matrix.costAt(columnOrder[j][columnFirst[j]], j);
+            long long penalty = columnSecond[j] < columnOrder[j].size() ? matrix.costAt(columnOrder[j][columnSecond[j]], j) - first : first;
+            if (matrix.logging())
+                matrix.log() << " B" << j + 1 << " = " << penalty << ";";
+            consider(penalty, first, columnOrder[j][columnFirst[j]], j);
+        }
+        matrix.log() << std::endl;
+        if (row == -1)
+            break;
+        matrix.log() << "Maximum penalty " << bestPenalty << ", cell \033[33m(A" << row + 1 << "; B" << column + 1 << ")\033[0m" << std::endl;
+        int closed = allocate(row, column, currentSuppliers, currentConsumers, openRows, openColumns);
+        countOfSelected++;
+        if (closed & 1)
+        {
+            rowOpen[row] = false;
+            openRows--;
+        }
+        if (closed & 2)
+        {
+            columnOpen[column] = false;
+            openColumns--;
+        }
+    }
+    return countOfSelected;
+}
+
+// Russell's method: estimates c_ij - u_i - v_j with u_i, v_j the largest open
+// cost of the row and of the column; the most negative estimate is filled.
+int Solution::initialRussell(std::vector<unsigned long long> &currentSuppliers, std::vector<unsigned long long> &currentConsumers)
+{
+    ALGOM_PHASE("initial plan");
+    int rows = matrix.rows(), columns = matrix.columns();
+    std::vector<bool> rowOpen(rows, true), columnOpen(columns, true);
+    int openRows = rows, openColumns = columns;
+    std::vector<unsigned long long> u(rows), v(columns);
+    int countOfSelected = 0;
+    while (openRows > 0 && openColumns > 0)
+    {
+        std::fill(u.begin(), u.end(), 0);
+        std::fill(v.begin(), v.end(), 0);
+        for (int i = 0; i < rows; ++i)
+        {
+            for (const auto &route : matrix.routesOf(i))
+            {
+                if (rowOpen[i] && columnOpen[route.column])
+                {
+                    u[i] = std::max(u[i], route.cost);
+                    v[route.column] = std::max(v[route.column], route.cost);
+                }
+            }
+        }
+        long long mmin = 0;
+        int row = -1, column = -1;
+        for (int i = 0; i < rows; ++i)
+        {
+            for (const auto &route : matrix.routesOf(i))
+            {
+                if (!rowOpen[i] || !columnOpen[route.column])
+                    continue;
+                long long delta = (long long)route.cost - (long long)u[i] - (long long)v[route.column];
+                if (row == -1 || delta < mmin)
+                {
+                    mmin = delta;
+                    row = i;
+                    column = route.column;
+                }
+            }
+        }
+        if (row == -1)
+            break;
+        matrix.log() << "Minimum estimate " << mmin << ", cell \033[33m(A" << row + 1 << "; B" << column + 1 << ")\033[0m" << std::endl;
+        int closed = allocate(row, column, currentSuppliers, currentConsumers, openRows, openColumns);
+        countOfSelected++;
+        if (closed & 1)
+        {
+            rowOpen[row] = false;
+            openRows--;
+        }
+        if (closed & 2)
+        {
+            columnOpen[column] = false;
+            openColumns--;
+        }
+    }
+    return countOfSelected;
+}
+
+// Basis file:
+//   basis <rows> <columns> <cells>
+//   <row> <column>            one line per basic cell, 1-based
+//   u <u1> ... <um>
+//   v <v1> ... <vn>
+// The potentials are only for reference: edited costs change them, so a
+// warm start recomputes them from the cells.
+void Solution::saveBasis(std::ostream &out) const
+{
+    std::vector<std::pair<int, int>> cells;
+    for (int i = 0; i < matrix.rows(); ++i)
+    {
+        for (const auto &route : matrix.routesOf(i))
+        {
+            if (route.count != -1)
+                cells.push_back({i, route.column});
+        }
+    }
+    std::vector<long long> u, v;
+    calcPotentials(u, v);
+    out << "basis " << matrix.rows() << " " << matrix.columns() << " " << cells.size() << "\n";
+    for (const auto &[row, column] : cells)
+    {
+        out << row + 1 << " " << column + 1 << "\n";
+    }
+    out << "u";
+    for (long long it : u)
+    {
+        out << " " << it;
+    }
+    out << "\nv";
+    for (long long it : v)
+    {
+        out << " " << it;
+    }
+    out << "\n";
+}
+
+bool Solution::loadBasis(std::istream &in)
+{
+    std::string word;
+    int rows, columns, count;
+    if (!(in >> word >> rows >> columns >> count) || word != "basis")
+        return false;
+    warmBasis.clear();
+    for (int k = 0; k < count; ++k)
+    {
+        int row, column;
+        if (!(in >> row >> column))
+            return false;
+        warmBasis.push_back({row - 1, column - 1});
+    }
+    return true;
+}
+
+// Of the closed problem: routes, costs, supplies, demands and transit
+// arcs, but not the plan.
+unsigned long long Solution::problemHash() const
+{
+    checkpoint::Hash hash;
+    hash.add(matrix.rows());
+    hash.add(matrix.columns());
+    for (int i = 0; i < matrix.rows(); ++i)
+    {
+        hash.add((long long)matrix.supplierAt(i));
+        for (int k = 0; k < matrix.routeSize(i); ++k)
+        {
+            hash.add(matrix.routeColumn(i, k));
+            hash.add((long long)matrix.routeCost(i, k));
+        }
+    }
+    for (int j = 0; j < matrix.columns(); ++j)
+        hash.add((long long)matrix.consumersAt(j));
+    for (const auto &arc : matrix.transitArcs())
+    {
+        hash.add(arc.from);
+        hash.add(arc.to);
+        hash.add((long long)arc.cost);
+    }
+    return hash.get();
+}
+
+void Solution::saveCheckpoint() const
+{
+    ALGOM_PHASE("checkpoint");
+    bool saved = snapshots.save([this](checkpoint::Writer &out)
+                                {
+                                    out.put("algom-transport 2");
+                                    out.put(matrix.rows());
+                                    out.put(matrix.columns());
+                                    out.put((long long)problemHash());
+                                    std::vector<long long> cells;
+                                    for (int i = 0; i < matrix.rows(); ++i)
+                                    {
+                                        for (int k = 0; k < matrix.routeSize(i); ++k)
+                                        {
+                                            long long count = matrix.routeCount(i, k);
+                                            if (count != -1)
+                                                cells.insert(cells.end(), {i, k, count});
+                                        }
+                                    }
+                                    out.put(cells);
+                                });
+    if (!saved)
+        matrix.log() << "\033[31mCould not write the checkpoint\033[0m" << std::endl;
+}
+
+bool Solution::resume(std::istream &in)
+{
+    checkpoint::Reader reader(in);
+    int rows = 0, columns = 0;
+    std::vector<long long> cells;
+    long long hash = 0;
+    reader.expect("algom-transport 2");
+    reader.get(rows);
+    reader.get(columns);
+    reader.get(hash);
+    reader.get(cells);
+    matrix.makeClose();
+    if (!reader || rows != matrix.rows() || columns != matrix.columns() || (unsigned long long)hash != problemHash() ||
+        cells.size() % 3 != 0)
+        return false;
+    matrix.clearCounts();
+    for (size_t k = 0; k < cells.size(); k += 3)
+    {
+        if (cells[k] < 0 || cells[k] >= rows || cells[k + 1] < 0 || cells[k + 1] >= matrix.routeSize(cells[k]) || cells[k + 2] < 0)
+            return false;
+        matrix.setRouteCount(cells[k], cells[k + 1], cells[k + 2]);
+    }
+    paused = true;
+    matrix.log() << "Resumed from the checkpoint, Z = " << matrix.totalCost() << std::endl;
+    matrix.print();
+    return true;
+}
+
+// Flows of the basic tree for the current supplies and demands, found by
+// peeling leaves. They may come out negative after the supplies changed, so
+// they are kept apart from the counts, where -1 means a non-basic cell.
+Solution::Flows Solution::computeFlows() const
+{
+    int rows = matrix.rows(), nodes = rows + matrix.columns();
+    Flows flows(rows);
+    std::vector<std::vector<std::pair<int, int>>> adjacent(nodes);
+    std::vector<long long> rest(nodes);
+    for (int i = 0; i < rows; ++i)
+    {
+        rest[i] = matrix.supplierAt(i);
+        for (int k = 0; k < matrix.routeSize(i); ++k)
+        {
+            if (matrix.routeCount(i, k) == -1)
+                continue;
+            int column = matrix.routeColumn(i, k);
+            adjacent[i].push_back({rows + column, flows[i].size()});
+            adjacent[rows + column].push_back({i, flows[i].size()});
+            flows[i].push_back({k, 0});
+        }
+    }
+    for (int j = 0; j < matrix.columns(); ++j)
+    {
+        rest[rows + j] = matrix.consumersAt(j);
+    }
+    std::vector<int> degree(nodes), queue;
+    for (int node = 0; node < nodes; ++node)
+    {
+        degree[node] = adjacent[node].size();
+        if (degree[node] == 1)
+            queue.push_back(node);
+    }
+    for (int k = 0; k < queue.size(); ++k)
+    {
+        int leaf = queue[k];
+        if (degree[leaf] != 1)
+            continue;
+        for (const auto &[other, position] : adjacent[leaf])
+        {
+            if (degree[other] == 0)
+                continue;
+            flows[std::min(leaf, other)][position].second = rest[leaf];
+            rest[other] -= rest[leaf];
+            degree[leaf] = 0;
+            if (--degree[other] == 1)
+                queue.push_back(other);
+            break;
+        }
+    }
+    return flows;
+}
+
+// Dual simplex on the transport tree: the most negative basic cell leaves,
+// splitting the tree in two, and the cheapest reduced cost among routes from
+// the column's side back to the row's side enters. Returns the number of
+// pivots, or -1 if the basis cannot be repaired.
+long long Solution::repairFeasibility(Flows &flows)
+{
+    int rows = matrix.rows(), nodes = rows + matrix.columns();
+    long long pivots = 0;
+    std::vector<long long> u, v;
+    std::vector<int> side(nodes);
+    while (true)
+    {
+        long long worst = 0;
+        int row = -1, column = -1;
+        for (int i = 0; i < rows; ++i)
+        {
+            for (const auto &[index, flow] : flows[i])
+            {
+                if (flow < worst)
+                {
+                    worst = flow;
+                    row = i;
+                    column = matrix.routeColumn(i, index);
+                }
+            }
+        }
+        if (row == -1)
+            return pivots;
+        if (pivots > 4 * nodes)
+            return -1;
+
+        std::fill(side.begin(), side.end(), 0);
+        std::vector<int> queue = {row};
+        side[row] = 1;
+        for (int k = 0; k < queue.size(); ++k)
+        {
+            int node = queue[k];
+            auto visit = [&](int next, int i, int j)
+            {
+                if (side[next] == 0 && !(i == row && j == column))
+                {
+                    side[next] = 1;
+                    queue.push_back(next);
+                }
+            };
+            if (node < rows)
+            {
+                for (const auto &route : matrix.routesOf(node))
+                {
+                    if (route.count != -1)
+                        visit(rows + route.column, node, route.column);
+                }
+            }
+            else
+            {
+                for (const auto &[i, index] : matrix.routesTo(node - rows))
+                {
+                    if (matrix.routesOf(i)[index].count != -1)
+                        visit(i, i, node - rows);
+                }
+            }
+        }
+
+        calcPotentials(u, v);
+        long long best = 0;
+        int enterRow = -1, enterColumn = -1;
+        for (int i = 0; i < rows; ++i)
+        {
+            if (side[i])
+                continue;
+            for (const auto &route : matrix.routesOf(i))
+            {
+                if (route.count != -1 || !side[rows + route.column])
+                    continue;
+                long long delta = (long long)route.cost - u[i] - v[route.column];
+                if (enterRow == -1 || delta < best)
+                {
+                    best = delta;
+                    enterRow = i;
+                    enterColumn = route.column;
+                }
+            }
+        }
+        if (enterRow == -1)
+            return -1;
+
+        // The leaving cell sits at an even position of the cycle, so -worst
+        // added there brings it to zero.
+        std::vector<std::pair<int, int>> cycle = findCycle(enterRow, enterColumn);
+        matrix.setCountAt(enterRow, enterColumn, 0);
+        flows[enterRow].push_back({matrix.routeIndex(enterRow, enterColumn), 0});
+        for (int k = 0; k < cycle.size(); ++k)
+        {
+            int index = matrix.routeIndex(cycle[k].first, cycle[k].second);
+            for (auto &[at, flow] : flows[cycle[k].first])
+            {
+                if (at == index)
+                    flow += k % 2 ? worst : -worst;
+            }
+        }
+        matrix.setCountAt(row, column, -1);
+        auto &cells = flows[row];
+        cells.erase(std::find_if(cells.begin(), cells.end(), [&](const std::pair<int, long long> &cell)
+                                 { return cell.first == matrix.routeIndex(row, column); }));
+        pivots++;
+        matrix.log() << "Repair " << pivots << ": \033[31m(A" << row + 1 << "; B" << column + 1 << ")\033[0m = " << worst
+                     << " leaves, \033[33m(A" << enterRow + 1 << "; B" << enterColumn + 1 << ")\033[0m enters" << std::endl;
+    }
+}
+
+// The saved cells that still exist become the basis, makeTree() completes
+// or trims them to a tree, and the dual pivots above restore feasibility.
+bool Solution::warmStart(long long &pivots)
+{
+    ALGOM_PHASE("warm start");
+    for (const auto &[row, column] : warmBasis)
+    {
+        if (row >= 0 && row < matrix.rows() && column >= 0 && column < matrix.columns() && matrix.routeIndex(row, column) != -1)
+            matrix.setCountAt(row, column, 0);
+    }
+    makeTree();
+    Flows flows = computeFlows();
+    pivots = repairFeasibility(flows);
+    matrix.clearCounts();
+    for (int i = 0; pivots != -1 && i < matrix.rows(); ++i)
+    {
+        for (const auto &[index, flow] : flows[i])
+        {
+            matrix.setRouteCount(i, index, flow);
+        }
+    }
+    if (pivots == -1)
+    {
+        matrix.log() << "The saved basis cannot be repaired, solving from scratch" << std::endl;
+        return false;
+    }
+    matrix.log() << "Warm start from the saved basis, " << pivots << " repair pivots: Z = " << matrix.totalCost() << std::endl;
+    matrix.print();
+    return true;
+}
+
+bool Solution::setMethod(const std::string &method)
+{
+    if (method != "min" && method != "vogel" && method != "russell")
+        return false;
+    this->method = method;
+    methodChosen = true;
+    return true;
+}
+
+bool Solution::setEngine(const std::string &engine)
+{
+    if (engine != "auto" && engine != "modi" && engine != "network" && engine != "scaling" && engine != "auction")
+        return false;
+    this->engine = engine;
+    return true;
+}
+
+bool Solution::setObjective(const std::string &objective)
+{
+    if (objective != "cost" && objective != "bottleneck")
+        return false;
+    this->objective = objective;
+    return true;
+}
+
+// The network simplex engine is meant for problems far too large to print,
+// so only its summary and the expenses are logged.
+bool Solution::runNetworkSimplex(long long &pivots)
+{
+    ALGOM_PHASE("network simplex");
+    NetworkSimplex network(matrix);
+    pivots = network.run();
+    if (!network.feasible())
+        return false;
+    matrix.clearCounts();
+    for (const auto &[row, index, flow] : network.plan())
+    {
+        matrix.setRouteCount(row, index, flow);
+    }
+    matrix.log() << "Network simplex: " << pivots << " pivots, the plan is optimal: Z = " << matrix.totalCost() << std::endl
+                 << std::endl;
+    return true;
+}
+
+// Balancing adds one dummy node wired to the short side with zero-cost
+// arcs instead of a dense row or column. A hub node joined to every supply
+// and demand node by arcs dearer than any real path keeps the network
+// feasible, so flow left on the hub arcs means the demand cannot be met.
+bool Solution::runCostScaling(Stats &stats)
+{
+    ALGOM_PHASE("cost scaling");
+    int rows = matrix.rows(), columns = matrix.columns();
+    int nodes = rows + columns + matrix.transit();
+    int dummy = nodes, hub = nodes + 1;
+    CostScaling network(nodes + 2);
+
+    long long supplies = 0, demands = 0, maxCost = 0;
+    for (int i = 0; i < rows; ++i)
+    {
+        network.setSupply(i, matrix.supplierAt(i));
+        supplies += matrix.supplierAt(i);
+    }
+    for (int j = 0; j < columns; ++j)
+    {
+        network.setSupply(rows + j, -(long long)matrix.consumersAt(j));
+        demands += matrix.consumersAt(j);
+    }
+    long long capacity = std::max(supplies, demands);
+
+    std::vector<std::vector<int>> direct(rows);
+    for (int i = 0; i < rows; ++i)
+    {
+        for (const auto &route : matrix.routesOf(i))
+        {
+            direct[i].push_back(network.addArc(i, rows + route.column, route.cost, capacity));
+            maxCost = std::max(maxCost, (long long)route.cost);
+        }
+    }
+    std::vector<int> transit;
+    for (const auto &arc : matrix.transitArcs())
+    {
+        transit.push_back(network.addArc(arc.from, arc.to, arc.cost, capacity));
+        maxCost = std::max(maxCost, (long long)arc.cost);
+    }
+
+    if (supplies != demands)
+    {
+        matrix.log() << "The model of the transport task is open! A dummy " << (supplies > demands ? "consumer" : "supplier")
+                     << " takes " << std::abs(supplies - demands) << std::endl;
+        network.setSupply(dummy, demands - supplies);
+        for (int i = 0; supplies > demands && i < rows; ++i)
+        {
+            network.addArc(i, dummy, 0, capacity);
+        }
+        for (int j = 0; demands > supplies && j < columns; ++j)
+        {
+            network.addArc(dummy, rows + j, 0, capacity);
+        }
+    }
+    else
+        matrix.log() << "The model of the transport task is closed!" << std::endl;
+
+    long long penalty = maxCost * (nodes + 1) + 1;
+    std::vector<int> artificial;
+    for (int v = 0; v <= nodes; ++v)
+    {
+        long long supply = v < rows ? (long long)matrix.supplierAt(v)
+                           : v < rows + columns ? -(long long)matrix.consumersAt(v - rows)
+                           : v == dummy ? demands - supplies : 0;
+        if (supply > 0)
+            artificial.push_back(network.addArc(v, hub, penalty, capacity));
+        else if (supply < 0)
+            artificial.push_back(network.addArc(hub, v, penalty, capacity));
+    }
+
+    network.run();
+    stats.pivots = network.pushCount();
+    stats.iterations = network.relabelCount();
+    for (int id : artificial)
+    {
+        if (network.flowAt(id) > 0)
+            return false;
+    }
+    for (int i = 0; i < rows; ++i)
+    {
+        for (int k = 0; k < direct[i].size(); ++k)
+        {
+            long long flow = network.flowAt(direct[i][k]);
+            matrix.setRouteCount(i, k, flow > 0 ? flow : -1);
+        }
+    }
+    for (size_t k = 0; k < transit.size(); ++k)
+    {
+        matrix.setArcCount(k, network.flowAt(transit[k]));
+    }
+    matrix.log() << "Cost scaling: " << stats.pivots << " pushes, " << stats.iterations << " relabels, the flow is optimal: Z = "
+                 << matrix.totalCost() << std::endl
+                 << std::endl;
+    return true;
+}
+
+bool Solution::runAuction(Stats &stats)
+{
+    ALGOM_PHASE("auction");
+    Auction auction(matrix, threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency()));
+    if (!auction.run())
+        return false;
+    matrix.clearCounts();
+    for (const auto &[row, column] : auction.assignment())
+    {
+        matrix.setCountAt(row, column, std::max(0ll, matrix.countAt(row, column)) + 1);
+    }
+    stats.pivots = auction.bidCount();
+    stats.iterations = auction.phaseCount();
+    matrix.log() << "Auction: " << stats.pivots << " bids in " << stats.iterations << " eps-scaling phases, the plan is optimal: Z = "
+                 << matrix.totalCost() << std::endl
+                 << std::endl;
+    return true;
+}
+
+bool Solution::runBottleneck(Stats &stats, unsigned long long &threshold)
+{
+    ALGOM_PHASE("bottleneck");
+    Bottleneck bottleneck(matrix);
+    bool feasible = bottleneck.run();
+    stats.pivots = bottleneck.pathCount();
+    stats.iterations = bottleneck.checkCount();
+    if (!feasible)
+        return false;
+    for (int i = 0; i < matrix.rows(); ++i)
+    {
+        for (int k = 0; k < matrix.routesOf(i).size(); ++k)
+        {
+            long long flow = bottleneck.flowAt(i, k);
+            matrix.setRouteCount(i, k, flow > 0 ? flow : -1);
+        }
+    }
+    for (int k = 0; k < matrix.transitArcs().size(); ++k)
+    {
+        matrix.setArcCount(k, bottleneck.arcFlow(k));
+    }
+    threshold = bottleneck.threshold();
+    matrix.log() << "Bottleneck: " << stats.iterations << " max-flow checks, " << stats.pivots
+                 << " augmenting paths, the longest used route costs " << threshold << std::endl;
+    matrix.print();
+    matrix.log() << "Z = " << matrix.totalCost() << std::endl
+                 << std::endl;
+    return true;
+}
+
+Result Solution::collect() const
+{
+    Result result;
+    result.status = Status::Optimal;
+    for (int i = 0; i < matrix.rows(); ++i)
+    {
+        for (int k = 0; k < matrix.routeSize(i); ++k)
+        {
+            long long count = matrix.routeCount(i, k);
+            if (count != -1)
+                result.plan.push_back({i, matrix.routeColumn(i, k), count});
+        }
+    }
+    result.cost = matrix.totalCost();
+    return result;
+}
+
+Result Solution::run()
+{
+    auto infeasible = [this](const Stats &stats)
+    {
+        matrix.log() << "The demand cannot be met through the given routes" << std::endl;
+        Result result;
+        result.status = Status::Infeasible;
+        result.stats = stats;
+        return result;
+    };
+    auto solved = [this](const Stats &stats)
+    {
+        matrix.printDistribution();
+        Result result = collect();
+        if (paused)
+            result.status = Status::Feasible;
+        result.stats = stats;
+        return result;
+    };
+    Stats stats;
+    Deadline deadline(budget);
+    if (paused)
+    {
+        paused = false;
+        matrix.log() << "Resuming the potentials method:" << std::endl;
+        stats.pivots = optimize(deadline);
+        stats.iterations = stats.pivots;
+        return solved(stats);
+    }
+    if (objective == "bottleneck")
+    {
+        unsigned long long threshold = 0;
+        if (!runBottleneck(stats, threshold))
+            return infeasible(stats);
+        Result result = solved(stats);
+        result.bottleneck = threshold;
+        return result;
+    }
+    if (engine == "scaling" || !matrix.transitArcs().empty())
+    {
+        if (!runCostScaling(stats))
+            return infeasible(stats);
+        return solved(stats);
+    }
+    bool warm = !warmBasis.empty() && (engine == "auto" || engine == "modi");
+    // Supplies and demands of a few units make the problem an assignment,
+    // unless an initial plan was asked for.
+    bool assignment = engine == "auto" && !warm && !methodChosen && Auction::suits(matrix);
+    if (engine == "auction" || assignment)
+    {
+        if (assignment)
+            matrix.log() << "Supplies and demands of at most " << Auction::maxAmount << " units: solving by the auction" << std::endl;
+        matrix.makeClose();
+        if (!runAuction(stats))
+            return infeasible(stats);
+        return solved(stats);
+    }
+    if (engine == "network")
+    {
+        matrix.makeClose();
+        if (!runNetworkSimplex(stats.pivots))
+            return infeasible(stats);
+        stats.iterations = stats.pivots;
+        return solved(stats);
+    }
+    matrix.print();
+    int rows = matrix.rows(), columns = matrix.columns();
+    int opened = matrix.makeClose();
+    long long repairs = 0;
+    if (warm && warmStart(repairs))
+    {
+        stats.pivots = repairs + optimize(deadline);
+        stats.iterations = stats.pivots;
+        return solved(stats);
+    }
+    std::vector<unsigned long long> currentSuppliers(matrix.rows(), 0);
+    std::vector<unsigned long long> currentConsumers(matrix.columns(), 0);
+    int countOfSelected = 0;
+    if (method == "vogel")
+        countOfSelected = initialVogel(currentSuppliers, currentConsumers);
+    else if (method == "russell")
+        countOfSelected = initialRussell(currentSuppliers, currentConsumers);
+    else
+    {
+        CellOrder order(matrix, rows, columns);
+        countOfSelected = initialMinimalCost(order, opened, currentSuppliers, currentConsumers);
+    }
+
+    // With forbidden routes a greedy plan can get stuck before everything is
+    // shipped; the network simplex then either finishes the job or proves
+    // that no plan exists.
+    bool shipped = true;
+    for (int i = 0; i < matrix.rows(); ++i)
+    {
+        shipped = shipped && currentSuppliers[i] == matrix.supplierAt(i);
+    }
+    for (int j = 0; j < matrix.columns(); ++j)
+    {
+        shipped = shipped && currentConsumers[j] == matrix.consumersAt(j);
+    }
+    if (!shipped)
+    {
+        matrix.log() << "The initial plan cannot ship everything over the given routes, the network simplex takes over" << std::endl;
+        matrix.clearCounts();
+        if (!runNetworkSimplex(stats.pivots))
+            return infeasible(stats);
+        stats.iterations = countOfSelected + stats.pivots;
+        return solved(stats);
+    }
+
+    if (countOfSelected < matrix.rows() + matrix.columns() - 1)
+    {
+        int ct = matrix.rows() + matrix.columns() - 1 - countOfSelected;
+        matrix.log() << "The plan is degenerate, it is necessary to add " << ct << " variables to the basis in:" << std::endl;
+        CellOrder order(matrix, rows, columns);
+        int row, column;
+        while (ct > 0 && order.next(row, column))
+        {
+            if (matrix.countAt(row, column) == -1)
+            {
+                matrix.setCountAt(row, column, 0);
+                matrix.log() << "\033[33m(A" << row + 1 << "; B" << column + 1 << ")\033[0m" << std::endl;
+                ct--;
+            }
+        }
+        matrix.print(currentSuppliers, currentConsumers);
+    }
+    matrix.log() << "Initial plan: Z = " << matrix.totalCost() << std::endl
+                 << std::endl;
+    stats.pivots = optimize(deadline);
+    stats.iterations = countOfSelected + stats.pivots;
+    return solved(stats);
+}
+
+}
@@ -0,0 +1,300 @@
+#pragma once
+#include "checkpoint.hpp"
+#include "result.hpp"
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace transport
+{
+
+// A basic cell of the final plan; degenerate ones ship zero.
+struct Allocation
+{
+    int row, column;
+    long long count;
+};
+
+struct Result
+{
+    Status status = Status::Feasible;
+    std::vector<Allocation> plan;
+    unsigned long long cost = 0;
+    // The dearest route or arc the plan uses, for the bottleneck objective.
+    unsigned long long bottleneck = 0;
+    Stats stats;
+};
+
+// An extra arc of a transshipment network. Nodes 0..m-1 are the suppliers,
+// m..m+n-1 the consumers and m+n.. the transit nodes.
+struct Arc
+{
+    int from, to;
+    unsigned long long cost;
+    long long count = 0;
+};
+
+// A permitted supplier -> consumer route. Every row keeps its routes sorted
+// by column, so a dense table has route j at index j.
+struct Route
+{
+    int column;
+    unsigned long long cost;
+    long long count = -1;
+};
+
+class Matrix;
+
+// The routes of one row, read from the Matrix's flat storage on the fly.
+class RouteList
+{
+private:
+    const Matrix *matrix;
+    int row;
+
+public:
+    class iterator
+    {
+    private:
+        const Matrix *matrix;
+        int row, index;
+
+    public:
+        iterator(const Matrix *matrix, int row, int index) : matrix(matrix), row(row), index(index) {}
+        Route operator*() const;
+        iterator &operator++()
+        {
+            ++index;
+            return *this;
+        }
+        bool operator!=(const iterator &other) const { return index != other.index; }
+    };
+
+    RouteList(const Matrix *matrix, int row) : matrix(matrix), row(row) {}
+    int size() const;
+    Route operator[](int index) const;
+    iterator begin() const { return iterator(matrix, row, 0); }
+    iterator end() const { return iterator(matrix, row, size()); }
+};
+
+// (row, index in routesOf(row)) of every route into one column.
+class IncomingList
+{
+private:
+    const Matrix *matrix;
+    int column;
+
+public:
+    class iterator
+    {
+    private:
+        const IncomingList *list;
+        int k;
+
+    public:
+        iterator(const IncomingList *list, int k) : list(list), k(k) {}
+        std::pair<int, int> operator*() const { return (*list)[k]; }
+        iterator &operator++()
+        {
+            ++k;
+            return *this;
+        }
+        bool operator!=(const iterator &other) const { return k != other.k; }
+    };
+
+    IncomingList(const Matrix *matrix, int column) : matrix(matrix), column(column) {}
+    int size() const;
+    std::pair<int, int> operator[](int k) const;
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, size()); }
+};
+
+// Costs live in one flat row-major array, 32 bits wide unless some cost
+// needs more; a dense table stores no columns, a sparse one keeps them (and
+// the routes into every column) in compressed rows. The row or column
+// makeClose() adds costs nothing and is not stored at all. A bit per route
+// marks the basic cells, and only those have their count kept, in a short
+// allocation list per row.
+class Matrix
+{
+private:
+    int m_rows = 0, m_columns = 0;
+    int m_transit = 0;
+    bool dense = true;
+    bool wide = false;
+    bool closingRow = false, closingColumn = false;
+    std::vector<Arc> arcs;
+    int maxColumnWidth = 0;
+    std::vector<long long> start;
+    std::vector<int> columnOf;
+    std::vector<uint32_t> narrowCost;
+    std::vector<unsigned long long> wideCost;
+    std::vector<long long> incomingStart;
+    std::vector<std::pair<int, int>> incoming;
+    std::vector<long long> slotStart;
+    std::vector<uint64_t> basic;
+    std::vector<std::vector<std::pair<int, long long>>> allocation;
+    std::vector<unsigned long long> suppliers;
+    std::vector<unsigned long long> consumers;
+    std::ostream *out = nullptr;
+
+    int parseNode(const std::string &name) const;
+    int findRoute(int row, int column) const;
+    void pushCost(unsigned long long cost);
+    void index();
+    void layout();
+    int storedRoutes(int row) const { return closingRow && row == m_rows - 1 ? 0 : start[row + 1] - start[row]; }
+    bool isBasic(long long slot) const { return basic[slot >> 6] >> (slot & 63) & 1; }
+
+    friend class IncomingList;
+
+public:
+    Matrix(){};
+    Matrix(std::istream &in);
+    Matrix(const std::vector<std::vector<unsigned long long>> &cost, const std::vector<unsigned long long> &suppliers,
+           const std::vector<unsigned long long> &consumers);
+    void setOutput(std::ostream *out) { this->out = out; }
+    bool logging() const { return out != nullptr; }
+    std::ostream &log() const;
+    int rows() const { return m_rows; }
+    int columns() const { return m_columns; }
+    bool isDense() const { return dense; }
+    int routeIndex(int row, int column) const { return dense ? column : findRoute(row, column); }
+    RouteList routesOf(int row) const { return RouteList(this, row); }
+    IncomingList routesTo(int column) const { return IncomingList(this, column); }
+    int routeSize(int row) const
+    {
+        return closingRow && row == m_rows - 1 ? m_columns : start[row + 1] - start[row] + closingColumn;
+    }
+    int routeColumn(int row, int index) const
+    {
+        if (dense || (closingRow && row == m_rows - 1))
+            return index;
+        return index == storedRoutes(row) ? m_columns - 1 : columnOf[start[row] + index];
+    }
+    unsigned long long routeCost(int row, int index) const
+    {
+        if (index >= storedRoutes(row))
+            return 0;
+        return wide ? wideCost[start[row] + index] : narrowCost[start[row] + index];
+    }
+    long long routeCount(int row, int index) const;
+    unsigned long long costAt(int row, int column) const { return routeCost(row, routeIndex(row, column)); }
+    long long countAt(int row, int column) const
+    {
+        int index = routeIndex(row, column);
+        return index == -1 ? -1 : routeCount(row, index);
+    }
+    void setCountAt(int row, int column, long long count) { setRouteCount(row, routeIndex(row, column), count); }
+    void setRouteCount(int row, int index, long long count);
+    // Makes every cell non-basic.
+    void clearCounts();
+    unsigned long long supplierAt(int index) const { return suppliers[index]; }
+    unsigned long long consumersAt(int index) const { return consumers[index]; }
+    int transit() const { return m_transit; }
+    const std::vector<Arc> &transitArcs() const { return arcs; }
+    void setArcCount(int index, long long count) { arcs[index].count = count; }
+    std::string nodeName(int node) const;
+    void print() const;
+    void print(std::vector<unsigned long long>& currentSupplier, std::vector<unsigned long long>& currentConsumer) const;
+    int makeClose();
+    unsigned long long totalCost() const;
+    void printDistribution() const;
+};
+
+inline int RouteList::size() const { return matrix->routeSize(row); }
+
+inline Route RouteList::operator[](int index) const
+{
+    return {matrix->routeColumn(row, index), matrix->routeCost(row, index), matrix->routeCount(row, index)};
+}
+
+inline Route RouteList::iterator::operator*() const { return RouteList(matrix, row)[index]; }
+
+// The routes of the first rows x columns of a Matrix cheapest first, ties by
+// row and then column, produced lazily instead of by sorting every cell.
+// Each row keeps a heap of 32-bit route indices and a heap of rows is keyed
+// on their cheapest route. A closed row drops out whole, and routes into a
+// closed column are skipped once they reach the top of their row.
+class CellOrder
+{
+private:
+    const Matrix &matrix;
+    std::vector<size_t> offset;
+    std::vector<uint32_t> cells, size, rowHeap;
+    std::vector<bool> rowOpen, columnOpen;
+
+    bool cellGreater(int row, uint32_t a, uint32_t b) const;
+    bool rowGreater(uint32_t a, uint32_t b) const;
+
+public:
+    CellOrder(const Matrix &matrix, int rows, int columns);
+    bool next(int &row, int &column);
+    void closeRow(int row) { rowOpen[row] = false; }
+    void closeColumn(int column) { columnOpen[column] = false; }
+};
+
+class Solution
+{
+private:
+    Matrix matrix;
+    std::string method = "min";
+    bool methodChosen = false;
+    std::string engine = "auto";
+    std::string objective = "cost";
+    int threads = 0;
+    std::vector<std::pair<int, int>> warmBasis;
+    Budget budget;
+    bool paused = false;
+    checkpoint::Schedule snapshots;
+
+    int allocate(int row, int column, std::vector<unsigned long long> &currentSuppliers,
+                 std::vector<unsigned long long> &currentConsumers, int openRows, int openColumns);
+    int initialMinimalCost(CellOrder &order, int opened,
+                           std::vector<unsigned long long> &currentSuppliers, std::vector<unsigned long long> &currentConsumers);
+    int initialVogel(std::vector<unsigned long long> &currentSuppliers, std::vector<unsigned long long> &currentConsumers);
+    int initialRussell(std::vector<unsigned long long> &currentSuppliers, std::vector<unsigned long long> &currentConsumers);
+    bool makeTree();
+    void calcPotentials(std::vector<long long> &u, std::vector<long long> &v) const;
+    std::vector<std::pair<int, int>> findCycle(int row, int column) const;
+    long long optimize(Deadline &deadline);
+    void saveCheckpoint() const;
+    unsigned long long problemHash() const;
+    // (route index, flow) of the basic cells of every row.
+    using Flows = std::vector<std::vector<std::pair<int, long long>>>;
+    Flows computeFlows() const;
+    long long repairFeasibility(Flows &flows);
+    bool warmStart(long long &pivots);
+    bool runNetworkSimplex(long long &pivots);
+    bool runCostScaling(Stats &stats);
+    bool runAuction(Stats &stats);
+    bool runBottleneck(Stats &stats, unsigned long long &threshold);
+    Result collect() const;
+
+public:
+    Solution(Matrix matrix) : matrix(std::move(matrix)) {}
+    bool setMethod(const std::string &method);
+    bool setEngine(const std::string &engine);
+    bool setObjective(const std::string &objective);
+    // Worker threads of the parallel engines, 0 = one per hardware thread.
+    void setThreads(int threads) { this->threads = threads; }
+    // The basic cells and potentials of the last run, and a basis saved that
+    // way to start the next run from.
+    void saveBasis(std::ostream &out) const;
+    bool loadBasis(std::istream &in);
+    // Steps are iterations of the potentials method; the other engines run
+    // to the end. A run stopped by the budget returns its plan as
+    // Status::Feasible, and the next run() continues the iterations.
+    void setBudget(const Budget &budget) { this->budget = budget; }
+    // Saves the plan to path every few seconds of the potentials method and
+    // when the budget stops it; resume() loads such a file into a Solution
+    // of the same problem, and run() goes on from that plan.
+    void setCheckpoint(const std::string &path, double seconds) { snapshots.set(path, seconds); }
+    bool resume(std::istream &in);
+    Result run();
+    bool canResume() const { return paused; }
+};
+
+}
@@ -0,0 +1,203 @@
+#include "generators.hpp"
+#include "counters.hpp"
+#include "gauss.hpp"
+#include "simplex/simplex.hpp"
+#include "3lab/transport.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+struct Measurement
+{
+    double wallMs = 0;
+    long long pivots = 0;
+    long long iterations = 0;
+    long long bitGrowth = 0;
+    int peakBits = 0;
+    unsigned long long gcdCalls = 0;
+    unsigned long long bytesAllocated = 0;
+    unsigned long long allocations = 0;
+    Status status = Status::Optimal;
+};
+
+struct Instance
+{
+    std::string solver;
+    std::string kind;
+    std::function<Stats(std::mt19937_64 &, int, Status &)> run;
+};
+
+static std::vector<Instance> instances()
+{
+    auto gauss = [](generators::LinearSystem (*generate)(int, std::mt19937_64 &), const char *pivot = "largest")
+    {
+        return [generate, pivot](std::mt19937_64 &rng, int size, Status &status)
+        {
+            gauss::Matrix matrix(generate(size, rng).augmented);
+            matrix.setPivot(pivot);
+            gauss::Result result = matrix.JordanGauss();
+            status = result.status;
+            return result.stats;
+        };
+    };
+    auto simplex = [](generators::LinearProgram (*generate)(int, std::mt19937_64 &))
+    {
+        return [generate](std::mt19937_64 &rng, int size, Status &status)
+        {
+            generators::LinearProgram program = generate(size, rng);
+            simplex::Matrix matrix(program.constraints, program.symbols, program.rhs, program.objective, program.isMax);
+            simplex::Result result = matrix.Simplex();
+            status = result.status;
+            return result.stats;
+        };
+    };
+    auto transport = [](generators::TransportProblem (*generate)(int, std::mt19937_64 &), const char *engine = "modi")
+    {
+        return [generate, engine](std::mt19937_64 &rng, int size, Status &status)
+        {
+            generators::TransportProblem problem = generate(size, rng);
+            transport::Solution solution(transport::Matrix(problem.cost, problem.suppliers, problem.consumers));
+            solution.setEngine(engine);
+            transport::Result result = solution.run();
+            status = result.status;
+            return result.stats;
+        };
+    };
+    return {
+        {"gauss", "dense", gauss(generators::denseSystem)},
+        {"gauss", "sparse", gauss(generators::sparseSystem)},
+        {"gauss", "dense-height", gauss(generators::denseSystem, "height")},
+        {"gauss", "sparse-height", gauss(generators::sparseSystem, "height")},
+        {"simplex", "feasible", simplex(generators::feasibleProgram)},
+        {"simplex", "infeasible", simplex(generators::infeasibleProgram)},
+        {"simplex", "unbounded", simplex(generators::unboundedProgram)},
+        {"transport", "balanced", transport(generators::balancedTransport)},
+        {"transport", "unbalanced", transport(generators::unbalancedTransport)},
+        {"transport", "network", transport(generators::unbalancedTransport, "network")},
+        {"transport", "scaling", transport(generators::unbalancedTransport, "scaling")},
+        {"transport", "assignment", transport(generators::assignmentTransport, "auto")},
+    };
+}
+
+// Each measurement runs in a forked child, so the peak RSS reported by wait4()
+// belongs to that instance alone and an overflow abort or a timeout only loses
+// one data point.
+static std::string measure(const Instance &instance, int size, unsigned long long seed, int timeout, Measurement &measurement, long &peakRss)
+{
+    int fd[2];
+    if (pipe(fd) != 0)
+        return "error";
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        close(fd[0]);
+        alarm(timeout);
+        std::mt19937_64 rng(seed * 1000003 + size);
+        Measurement result;
+        counters::reset();
+        auto start = std::chrono::steady_clock::now();
+        Stats stats = instance.run(rng, size, result.status);
+        auto end = std::chrono::steady_clock::now();
+        result.wallMs = std::chrono::duration<double, std::milli>(end - start).count();
+        result.pivots = stats.pivots;
+        result.iterations = stats.iterations;
+        result.bitGrowth = stats.bitGrowth;
+        result.peakBits = stats.peakBits;
+        counters::Totals counted = counters::totals();
+        result.gcdCalls = counted.gcdCalls;
+        result.bytesAllocated = counted.bytesAllocated;
+        result.allocations = counted.allocations;
+        ssize_t written = write(fd[1], &result, sizeof(result));
+        _exit(written == sizeof(result) ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+    close(fd[1]);
+    ssize_t received = read(fd[0], &measurement, sizeof(measurement));
+    close(fd[0]);
+    int wstatus = 0;
+    rusage usage{};
+    wait4(pid, &wstatus, 0, &usage);
+    peakRss = usage.ru_maxrss;
+    if (WIFSIGNALED(wstatus) && WTERMSIG(wstatus) == SIGALRM)
+        return "timeout";
+    if (received != sizeof(measurement))
+        return "error";
+    return statusName(measurement.status);
+}
+
+static std::vector<int> parseSizes(const std::string &list)
+{
+    std::vector<int> sizes;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ','))
+    {
+        sizes.push_back(std::stoi(item));
+    }
+    return sizes;
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<int> sizes = {10, 30, 100};
+    unsigned long long seed = 1;
+    int timeout = 60;
+    std::string solver = "all";
+    std::string output;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--sizes" && i + 1 < argc)
+            sizes = parseSizes(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc)
+            seed = std::stoull(argv[++i]);
+        else if (arg == "--timeout" && i + 1 < argc)
+            timeout = std::stoi(argv[++i]);
+        else if (arg == "--solver" && i + 1 < argc)
+            solver = argv[++i];
+        else if (arg == "--out" && i + 1 < argc)
+            output = argv[++i];
+        else
+        {
+            std::cerr << "./bench [--sizes 10,100,1000] [--seed N] [--timeout sec] [--solver gauss|simplex|transport|all] [--out file.json]" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    std::ofstream file;
+    if (!output.empty())
+        file.open(output);
+    std::ostream &json = output.empty() ? std::cout : file;
+    json << "{\"seed\": " << seed << ", \"benchmarks\": [";
+    bool isFirst = true;
+    for (const auto &instance : instances())
+    {
+        if (solver != "all" && solver != instance.solver)
+            continue;
+        for (int size : sizes)
+        {
+            Measurement measurement;
+            long peakRss = 0;
+            std::string status = measure(instance, size, seed, timeout, measurement, peakRss);
+            std::cerr << instance.solver << "/" << instance.kind << " n=" << size << ": " << status << " " << measurement.wallMs << " ms" << std::endl;
+            json << (isFirst ? "\n" : ",\n") << "  {\"solver\": \"" << instance.solver << "\", \"instance\": \"" << instance.kind
+                 << "\", \"size\": " << size << ", \"status\": \"" << status << "\", \"wall_ms\": " << measurement.wallMs
+                 << ", \"pivots\": " << measurement.pivots << ", \"iterations\": " << measurement.iterations
+                 << ", \"bit_growth\": " << measurement.bitGrowth << ", \"peak_bits\": " << measurement.peakBits
+                 << ", \"gcd_calls\": " << measurement.gcdCalls << ", \"peak_rss_kb\": " << peakRss
+                 << ", \"bytes_allocated\": " << measurement.bytesAllocated << ", \"allocations\": " << measurement.allocations << "}";
+            isFirst = false;
+        }
+    }
+    json << "\n]}" << std::endl;
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include "planted.hpp"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+template <class Problem, class Instance>
+static void write(const std::filesystem::path &directory, const std::string &name, const Problem &problem, const Instance &instance)
+{
+    std::ofstream input(directory / (name + ".txt"));
+    planted::writeInput(input, problem);
+    std::ofstream answer(directory / (name + ".ans"));
+    planted::writeAnswer(answer, instance);
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<int> sizes = {10, 100};
+    int count = 3;
+    unsigned long long seed = 1;
+    std::string kind = "all";
+    std::filesystem::path directory = "corpus";
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--sizes" && i + 1 < argc)
+        {
+            sizes.clear();
+            std::stringstream ss(argv[++i]);
+            std::string item;
+            while (std::getline(ss, item, ','))
+                sizes.push_back(std::stoi(item));
+        }
+        else if (arg == "--count" && i + 1 < argc)
+            count = std::stoi(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc)
+            seed = std::stoull(argv[++i]);
+        else if (arg == "--kind" && i + 1 < argc)
+            kind = argv[++i];
+        else if (arg == "--out" && i + 1 < argc)
+            directory = argv[++i];
+        else
+        {
+            std::cerr << "./corpus [--out dir] [--sizes 10,100] [--count N] [--seed N] [--kind gauss|simplex|transport|all]" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    std::filesystem::create_directories(directory);
+    int files = 0;
+    for (int size : sizes)
+    {
+        for (int k = 1; k <= count; ++k)
+        {
+            std::mt19937_64 rng(seed * 1000003 + size * 1009 + k);
+            std::string suffix = "_n" + std::to_string(size) + "_" + std::to_string(k);
+            if (kind == "all" || kind == "gauss")
+            {
+                planted::System system = planted::plantedSystem(size, rng);
+                write(directory, "system" + suffix, system.system, system);
+                files++;
+            }
+            if (kind == "all" || kind == "simplex")
+            {
+                planted::Program program = planted::plantedProgram(size, size, rng);
+                write(directory, "lp" + suffix, program.program, program);
+                files++;
+            }
+            if (kind == "all" || kind == "transport")
+            {
+                planted::Transport transport = planted::plantedTransport(size, size + size / 2, rng);
+                write(directory, "transport" + suffix, transport.problem, transport);
+                files++;
+            }
+        }
+    }
+    std::cout << files << " instances with answers written to " << directory.string() << std::endl;
+    return 0;
+}
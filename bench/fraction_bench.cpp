@@ -0,0 +1,257 @@
+#include "generators.hpp"
+#include "counters.hpp"
+#include "gauss.hpp"
+#include "simplex/simplex.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+static unsigned long long cycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+struct Operands
+{
+    std::string name;
+    std::vector<Fraction> lhs, rhs;
+};
+
+static Operands randomOperands(const std::string &name, std::mt19937_64 &rng, int count,
+                               long long numerator, long long denominatorFrom, long long denominatorTo, bool nearOverflow)
+{
+    std::uniform_int_distribution<long long> num(nearOverflow ? numerator / 2 : -numerator, numerator);
+    std::uniform_int_distribution<long long> den(denominatorFrom, denominatorTo);
+    std::bernoulli_distribution negative(0.5);
+    Operands operands{name, {}, {}};
+    for (int i = 0; i < count; ++i)
+    {
+        long long a = num(rng), b = num(rng);
+        if (nearOverflow)
+        {
+            a = negative(rng) ? -a : a;
+            b = negative(rng) ? -b : b;
+        }
+        operands.lhs.push_back(Fraction(a == 0 ? 1 : a, den(rng)));
+        operands.rhs.push_back(Fraction(b == 0 ? 1 : b, den(rng)));
+    }
+    return operands;
+}
+
+static Operands *capture = nullptr;
+static size_t captureLimit = 0;
+
+static void captureHook(char, const Fraction &lhs, const Fraction &rhs)
+{
+    if (capture->lhs.size() < captureLimit)
+    {
+        capture->lhs.push_back(lhs);
+        capture->rhs.push_back(rhs);
+    }
+}
+
+// Operands of the Fraction operations the simplex and Gauss-Jordan solvers
+// still do outside the Row eliminations (Z row updates, ratio tests) on small
+// generated instances, which stay clear of overflow.
+static Operands capturedOperands(int count)
+{
+    Operands operands{"captured", {}, {}};
+    capture = &operands;
+    captureLimit = count;
+    counters::fractionHook = captureHook;
+    for (unsigned long long seed = 1; operands.lhs.size() < captureLimit && seed < 1000; ++seed)
+    {
+        std::mt19937_64 rng(seed);
+        generators::LinearProgram program = generators::feasibleProgram(6, rng);
+        simplex::Matrix(program.constraints, program.symbols, program.rhs, program.objective, program.isMax).Simplex();
+        gauss::Matrix(generators::denseSystem(7, rng).augmented).JordanGauss();
+    }
+    counters::fractionHook = nullptr;
+    return operands;
+}
+
+struct Measurement
+{
+    double nsPerOp = 0;
+    double opsPerCycle = 0;
+    double gcdPerOp = 0;
+    std::vector<unsigned long long> gcdHistogram = std::vector<unsigned long long>(5, 0);
+};
+
+static volatile long long sink;
+
+template <class Op>
+static Measurement measure(const Operands &operands, Op op, double minTimeMs)
+{
+    Measurement measurement;
+    size_t n = operands.lhs.size();
+    for (size_t i = 0; i < n; ++i)
+    {
+        unsigned long long before = counters::gcdCalls;
+        sink = op(operands.lhs[i], operands.rhs[i]);
+        unsigned long long calls = counters::gcdCalls - before;
+        measurement.gcdHistogram[std::min<unsigned long long>(calls, 4)]++;
+        measurement.gcdPerOp += calls;
+    }
+    measurement.gcdPerOp /= n;
+
+    unsigned long long repeats = 0;
+    long long acc = 0;
+    auto start = std::chrono::steady_clock::now();
+    unsigned long long startCycles = cycles();
+    double elapsed = 0;
+    while (elapsed < minTimeMs)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            acc += op(operands.lhs[i], operands.rhs[i]);
+        }
+        repeats++;
+        elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    unsigned long long spentCycles = cycles() - startCycles;
+    sink = acc;
+    double ops = (double)repeats * n;
+    measurement.nsPerOp = elapsed * 1e6 / ops;
+    measurement.opsPerCycle = spentCycles ? ops / spentCycles : 0;
+    return measurement;
+}
+
+int main(int argc, char **argv)
+{
+    int count = 1 << 14;
+    double minTimeMs = 100;
+    bool json = false;
+    unsigned long long seed = 1;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--ops" && i + 1 < argc)
+            count = std::stoi(argv[++i]);
+        else if (arg == "--min-time" && i + 1 < argc)
+            minTimeMs = std::stod(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc)
+            seed = std::stoull(argv[++i]);
+        else if (arg == "--json")
+            json = true;
+        else
+        {
+            std::cerr << "./fraction_bench [--ops N] [--min-time ms] [--seed N] [--json]" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    std::mt19937_64 rng(seed);
+    std::vector<Operands> classes = {
+        randomOperands("small", rng, count, 100, 1, 100, false),
+        randomOperands("near-overflow", rng, count, (1ll << 31) - 1, 1ll << 30, (1ll << 31) - 1, true),
+        randomOperands("large-denominators", rng, count, 1000, 1000000, 1000000000, false),
+        capturedOperands(count),
+    };
+
+    std::istringstream input;
+    std::ostringstream output;
+    std::vector<std::string> texts;
+
+    if (json)
+        std::cout << "{\"seed\": " << seed << ", \"fraction\": [";
+    else
+        std::cout << std::left << std::setw(20) << "class" << std::setw(8) << "op" << std::right << std::setw(10) << "ns/op"
+                  << std::setw(12) << "ops/cycle" << std::setw(10) << "gcd/op" << "   gcd calls 0/1/2/3/4+" << std::endl;
+    bool isFirst = true;
+    for (auto &operands : classes)
+    {
+        if (operands.lhs.empty())
+            continue;
+        std::vector<Fraction> divisors = operands.rhs;
+        for (auto &it : divisors)
+        {
+            if (it.numerator == 0)
+                it = Fraction(1);
+        }
+        Operands division{operands.name, operands.lhs, divisors};
+        texts.clear();
+        for (auto &it : operands.lhs)
+        {
+            output.str("");
+            output << it;
+            texts.push_back(output.str());
+        }
+        size_t parsed = 0;
+
+        auto report = [&](const std::string &op, const Measurement &m)
+        {
+            if (json)
+            {
+                std::cout << (isFirst ? "\n" : ",\n") << "  {\"class\": \"" << operands.name << "\", \"op\": \"" << op
+                          << "\", \"ns_per_op\": " << m.nsPerOp << ", \"ops_per_cycle\": " << m.opsPerCycle
+                          << ", \"gcd_per_op\": " << m.gcdPerOp << ", \"gcd_histogram\": [";
+                for (size_t i = 0; i < m.gcdHistogram.size(); ++i)
+                {
+                    std::cout << (i ? ", " : "") << m.gcdHistogram[i];
+                }
+                std::cout << "]}";
+            }
+            else
+            {
+                std::cout << std::left << std::setw(20) << operands.name << std::setw(8) << op << std::right << std::fixed
+                          << std::setprecision(2) << std::setw(10) << m.nsPerOp << std::setprecision(4) << std::setw(12) << m.opsPerCycle
+                          << std::setprecision(2) << std::setw(10) << m.gcdPerOp << "   ";
+                for (size_t i = 0; i < m.gcdHistogram.size(); ++i)
+                {
+                    std::cout << (i ? "/" : "") << std::setprecision(0) << 100.0 * m.gcdHistogram[i] / operands.lhs.size() << "%";
+                }
+                std::cout << std::endl;
+            }
+            isFirst = false;
+        };
+
+        report("+", measure(operands, [](const Fraction &a, const Fraction &b)
+                            { return (a + b).numerator; }, minTimeMs));
+        report("-=", measure(operands, [](const Fraction &a, const Fraction &b)
+                             { Fraction x = a; x -= b; return x.numerator; }, minTimeMs));
+        report("*", measure(operands, [](const Fraction &a, const Fraction &b)
+                            { return (a * b).numerator; }, minTimeMs));
+        report("/=", measure(division, [](const Fraction &a, const Fraction &b)
+                             { Fraction x = a; x /= b; return x.numerator; }, minTimeMs));
+        report("<", measure(operands, [](const Fraction &a, const Fraction &b)
+                            { return (long long)(a < b); }, minTimeMs));
+        report("==", measure(operands, [](const Fraction &a, const Fraction &b)
+                             { return (long long)(a == b); }, minTimeMs));
+        report("gcd", measure(operands, [](const Fraction &a, const Fraction &b)
+                              {
+                                  Fraction x;
+                                  x.numerator = a.numerator * b.denominator;
+                                  x.denominator = a.denominator * b.denominator;
+                                  x.calculateGcd();
+                                  return x.numerator; }, minTimeMs));
+        report("parse", measure(operands, [&](const Fraction &, const Fraction &)
+                                {
+                                    Fraction x;
+                                    input.clear();
+                                    input.str(texts[parsed++ % texts.size()]);
+                                    input >> x;
+                                    return x.numerator; }, minTimeMs));
+        report("print", measure(operands, [&](const Fraction &a, const Fraction &)
+                                {
+                                    output.str("");
+                                    output << a;
+                                    return (long long)output.tellp(); }, minTimeMs));
+    }
+    if (json)
+        std::cout << "\n]}" << std::endl;
+    return 0;
+}
@@ -0,0 +1,138 @@
+#include "generators.hpp"
+#include <algorithm>
+#include <numeric>
+
+namespace generators
+{
+
+static long long uniform(std::mt19937_64 &rng, long long from, long long to)
+{
+    return std::uniform_int_distribution<long long>(from, to)(rng);
+}
+
+LinearSystem denseSystem(int n, std::mt19937_64 &rng)
+{
+    LinearSystem system;
+    system.augmented.resize(n, std::vector<Fraction>(n + 1));
+    for (auto &row : system.augmented)
+    {
+        for (auto &it : row)
+        {
+            it = Fraction(uniform(rng, -9, 9));
+        }
+    }
+    return system;
+}
+
+LinearSystem sparseSystem(int n, std::mt19937_64 &rng)
+{
+    LinearSystem system;
+    system.augmented.resize(n, std::vector<Fraction>(n + 1));
+    for (int i = 0; i < n; ++i)
+    {
+        system.augmented[i][i] = Fraction(uniform(rng, 1, 9));
+        for (int k = 0; k < 2; ++k)
+        {
+            system.augmented[i][uniform(rng, 0, n - 1)] = Fraction(uniform(rng, -9, 9));
+        }
+        system.augmented[i][n] = Fraction(uniform(rng, -9, 9));
+    }
+    return system;
+}
+
+LinearProgram feasibleProgram(int n, std::mt19937_64 &rng)
+{
+    LinearProgram program;
+    program.constraints.resize(n, std::vector<Fraction>(n));
+    program.symbols.assign(n, "<=");
+    program.rhs.resize(n);
+    program.objective.resize(n);
+    for (int i = 0; i < n; ++i)
+    {
+        for (auto &it : program.constraints[i])
+        {
+            it = Fraction(uniform(rng, 0, 9));
+        }
+        program.constraints[i][i] = Fraction(uniform(rng, 1, 9));
+        program.rhs[i] = Fraction(uniform(rng, 10, 100) * n);
+    }
+    for (auto &it : program.objective)
+    {
+        it = Fraction(uniform(rng, 1, 9));
+    }
+    return program;
+}
+
+LinearProgram infeasibleProgram(int n, std::mt19937_64 &rng)
+{
+    LinearProgram program = feasibleProgram(n, rng);
+    program.constraints.push_back(program.constraints[0]);
+    program.symbols.push_back(">=");
+    program.rhs.push_back(program.rhs[0] + Fraction(1));
+    return program;
+}
+
+LinearProgram unboundedProgram(int n, std::mt19937_64 &rng)
+{
+    LinearProgram program = feasibleProgram(n, rng);
+    int free = uniform(rng, 0, n - 1);
+    for (auto &row : program.constraints)
+    {
+        row[free] = Fraction(0);
+    }
+    return program;
+}
+
+TransportProblem balancedTransport(int n, std::mt19937_64 &rng)
+{
+    TransportProblem problem;
+    problem.cost.resize(n, std::vector<unsigned long long>(n));
+    for (auto &row : problem.cost)
+    {
+        for (auto &it : row)
+        {
+            it = uniform(rng, 1, 100);
+        }
+    }
+    problem.suppliers.resize(n);
+    problem.consumers.resize(n);
+    for (auto &it : problem.suppliers)
+    {
+        it = uniform(rng, 10, 500);
+    }
+    unsigned long long total = std::accumulate(problem.suppliers.begin(), problem.suppliers.end(), 0ull);
+    for (int j = 0; j < n; ++j)
+    {
+        problem.consumers[j] = total / n + (j < total % n ? 1 : 0);
+    }
+    std::shuffle(problem.consumers.begin(), problem.consumers.end(), rng);
+    return problem;
+}
+
+TransportProblem unbalancedTransport(int n, std::mt19937_64 &rng)
+{
+    TransportProblem problem = balancedTransport(n, rng);
+    for (auto &it : problem.consumers)
+    {
+        it = it * 3 / 4 + 1;
+    }
+    return problem;
+}
+
+TransportProblem assignmentTransport(int n, std::mt19937_64 &rng)
+{
+    TransportProblem problem;
+    problem.cost.resize(n, std::vector<unsigned long long>(n));
+    for (auto &row : problem.cost)
+    {
+        for (auto &it : row)
+        {
+            it = uniform(rng, 1, 1000);
+        }
+    }
+    problem.suppliers.assign(n, 1);
+    problem.consumers.assign(n, 1);
+    return problem;
+}
+
+}
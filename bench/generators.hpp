@@ -0,0 +1,45 @@
+#pragma once
+#include "fraction.hpp"
+#include <random>
+#include <string>
+#include <vector>
+
+// Seeded synthetic instances for the benchmark suite. Every generator is a
+// pure function of (size, rng state), so a seed reproduces the same instance
+// on every build.
+namespace generators
+{
+
+struct LinearSystem
+{
+    std::vector<std::vector<Fraction>> augmented;
+};
+
+struct LinearProgram
+{
+    std::vector<std::vector<Fraction>> constraints;
+    std::vector<std::string> symbols;
+    std::vector<Fraction> rhs;
+    std::vector<Fraction> objective;
+    bool isMax = true;
+};
+
+struct TransportProblem
+{
+    std::vector<std::vector<unsigned long long>> cost;
+    std::vector<unsigned long long> suppliers;
+    std::vector<unsigned long long> consumers;
+};
+
+LinearSystem denseSystem(int n, std::mt19937_64 &rng);
+LinearSystem sparseSystem(int n, std::mt19937_64 &rng);
+
+LinearProgram feasibleProgram(int n, std::mt19937_64 &rng);
+LinearProgram infeasibleProgram(int n, std::mt19937_64 &rng);
+LinearProgram unboundedProgram(int n, std::mt19937_64 &rng);
+
+TransportProblem balancedTransport(int n, std::mt19937_64 &rng);
+TransportProblem unbalancedTransport(int n, std::mt19937_64 &rng);
+TransportProblem assignmentTransport(int n, std::mt19937_64 &rng);
+
+}
@@ -0,0 +1,275 @@
+#include "planted.hpp"
+#include <algorithm>
+#include <numeric>
+#include <ostream>
+
+namespace planted
+{
+
+static long long uniform(std::mt19937_64 &rng, long long from, long long to)
+{
+    return std::uniform_int_distribution<long long>(from, to)(rng);
+}
+
+System plantedSystem(int n, std::mt19937_64 &rng)
+{
+    std::vector<std::vector<long long>> lower(n, std::vector<long long>(n, 0)), upper = lower;
+    for (int i = 0; i < n; ++i)
+    {
+        lower[i][i] = upper[i][i] = 1;
+        for (int j = 0; j < i; ++j)
+        {
+            lower[i][j] = uniform(rng, -1, 1);
+            upper[j][i] = uniform(rng, -2, 2);
+        }
+    }
+    std::vector<int> permutation(n);
+    std::iota(permutation.begin(), permutation.end(), 0);
+    std::shuffle(permutation.begin(), permutation.end(), rng);
+
+    System result;
+    result.solution.resize(n);
+    std::vector<long long> x(n);
+    for (int j = 0; j < n; ++j)
+    {
+        x[j] = uniform(rng, -9, 9);
+        result.solution[j] = Fraction(x[j]);
+    }
+    result.system.augmented.resize(n, std::vector<Fraction>(n + 1));
+    for (int i = 0; i < n; ++i)
+    {
+        const auto &row = lower[permutation[i]];
+        long long b = 0;
+        for (int j = 0; j < n; ++j)
+        {
+            long long a = 0;
+            for (int k = 0; k <= std::min(permutation[i], j); ++k)
+            {
+                a += row[k] * upper[k][j];
+            }
+            result.system.augmented[i][j] = Fraction(a);
+            b += a * x[j];
+        }
+        result.system.augmented[i][n] = Fraction(b);
+    }
+    return result;
+}
+
+Program plantedProgram(int rows, int columns, std::mt19937_64 &rng)
+{
+    int k = uniform(rng, 1, std::min(rows, columns));
+    std::vector<int> rowOrder(rows), columnOrder(columns);
+    std::iota(rowOrder.begin(), rowOrder.end(), 0);
+    std::iota(columnOrder.begin(), columnOrder.end(), 0);
+    std::shuffle(rowOrder.begin(), rowOrder.end(), rng);
+    std::shuffle(columnOrder.begin(), columnOrder.end(), rng);
+
+    std::vector<long long> x(columns, 0), y(rows, 0), reduced(columns, 0);
+    for (int i = 0; i < k; ++i)
+    {
+        x[columnOrder[i]] = uniform(rng, 1, 9);
+        y[rowOrder[i]] = uniform(rng, 1, 9);
+    }
+    for (int j = 0; j < columns; ++j)
+    {
+        if (x[j] == 0)
+            reduced[j] = uniform(rng, 1, 9);
+    }
+
+    std::vector<std::vector<long long>> a(rows, std::vector<long long>(columns));
+    for (auto &row : a)
+    {
+        for (auto &it : row)
+        {
+            it = uniform(rng, 1, 9);
+        }
+    }
+    std::vector<long long> b(rows), c(columns);
+    for (int i = 0; i < rows; ++i)
+    {
+        b[i] = std::inner_product(a[i].begin(), a[i].end(), x.begin(), 0ll);
+        if (y[i] == 0)
+            b[i] += uniform(rng, 1, 9);
+    }
+    for (int j = 0; j < columns; ++j)
+    {
+        c[j] = -reduced[j];
+        for (int i = 0; i < rows; ++i)
+        {
+            c[j] += a[i][j] * y[i];
+        }
+    }
+
+    Program result;
+    auto &program = result.program;
+    program.isMax = uniform(rng, 0, 1) == 1;
+    long long sense = program.isMax ? 1 : -1;
+    program.constraints.resize(rows, std::vector<Fraction>(columns));
+    program.symbols.resize(rows);
+    program.rhs.resize(rows);
+    result.dual.resize(rows);
+    for (int i = 0; i < rows; ++i)
+    {
+        long long sign = uniform(rng, 0, 3) == 0 ? -1 : 1;
+        for (int j = 0; j < columns; ++j)
+        {
+            program.constraints[i][j] = Fraction(sign * a[i][j]);
+        }
+        program.symbols[i] = sign == 1 ? "<=" : ">=";
+        program.rhs[i] = Fraction(sign * b[i]);
+        result.dual[i] = Fraction(sense * sign * y[i]);
+    }
+    long long objective = 0;
+    for (int j = 0; j < columns; ++j)
+    {
+        program.objective.push_back(Fraction(sense * c[j]));
+        result.solution.push_back(Fraction(x[j]));
+        objective += c[j] * x[j];
+    }
+    result.objective = Fraction(sense * objective);
+    return result;
+}
+
+Transport plantedTransport(int rows, int columns, std::mt19937_64 &rng)
+{
+    std::vector<std::vector<bool>> tree(rows, std::vector<bool>(columns, false));
+    std::vector<int> connectedRows = {0}, connectedColumns = {0};
+    tree[0][0] = true;
+    std::vector<int> pending;
+    for (int i = 1; i < rows; ++i)
+        pending.push_back(i);
+    for (int j = 1; j < columns; ++j)
+        pending.push_back(-j);
+    std::shuffle(pending.begin(), pending.end(), rng);
+    for (int node : pending)
+    {
+        if (node > 0)
+        {
+            tree[node][connectedColumns[uniform(rng, 0, connectedColumns.size() - 1)]] = true;
+            connectedRows.push_back(node);
+        }
+        else
+        {
+            tree[connectedRows[uniform(rng, 0, connectedRows.size() - 1)]][-node] = true;
+            connectedColumns.push_back(-node);
+        }
+    }
+
+    std::vector<unsigned long long> u(rows), v(columns);
+    for (auto &it : u)
+        it = uniform(rng, 0, 50);
+    for (auto &it : v)
+        it = uniform(rng, 0, 50);
+
+    Transport result;
+    auto &problem = result.problem;
+    problem.cost.resize(rows, std::vector<unsigned long long>(columns));
+    problem.suppliers.assign(rows, 0);
+    problem.consumers.assign(columns, 0);
+    result.plan.assign(rows, std::vector<unsigned long long>(columns, 0));
+    for (int i = 0; i < rows; ++i)
+    {
+        for (int j = 0; j < columns; ++j)
+        {
+            problem.cost[i][j] = u[i] + v[j];
+            if (tree[i][j])
+            {
+                result.plan[i][j] = uniform(rng, 1, 100);
+                problem.suppliers[i] += result.plan[i][j];
+                problem.consumers[j] += result.plan[i][j];
+                result.cost += result.plan[i][j] * problem.cost[i][j];
+            }
+            else
+                problem.cost[i][j] += uniform(rng, 1, 20);
+        }
+    }
+    return result;
+}
+
+void writeInput(std::ostream &os, const generators::LinearSystem &system)
+{
+    os << system.augmented.size() << " " << (system.augmented.empty() ? 0 : system.augmented[0].size()) << "\n";
+    for (const auto &row : system.augmented)
+    {
+        for (size_t j = 0; j < row.size(); ++j)
+        {
+            os << (j ? " " : "") << row[j];
+        }
+        os << "\n";
+    }
+}
+
+void writeInput(std::ostream &os, const generators::LinearProgram &program)
+{
+    os << program.constraints.size() << " " << program.objective.size() << "\n";
+    for (size_t i = 0; i < program.constraints.size(); ++i)
+    {
+        for (const auto &it : program.constraints[i])
+        {
+            os << it << " ";
+        }
+        os << program.symbols[i] << " " << program.rhs[i] << "\n";
+    }
+    for (const auto &it : program.objective)
+    {
+        os << it << " ";
+    }
+    os << (program.isMax ? "max" : "min") << "\n";
+}
+
+void writeInput(std::ostream &os, const generators::TransportProblem &problem)
+{
+    os << problem.suppliers.size() << " " << problem.consumers.size() << "\n";
+    for (size_t i = 0; i < problem.cost.size(); ++i)
+    {
+        for (const auto &it : problem.cost[i])
+        {
+            os << it << " ";
+        }
+        os << problem.suppliers[i] << "\n";
+    }
+    for (size_t j = 0; j < problem.consumers.size(); ++j)
+    {
+        os << (j ? " " : "") << problem.consumers[j];
+    }
+    os << "\n";
+}
+
+void writeAnswer(std::ostream &os, const System &system)
+{
+    for (size_t j = 0; j < system.solution.size(); ++j)
+    {
+        os << "x" << j + 1 << " = " << system.solution[j] << "\n";
+    }
+}
+
+void writeAnswer(std::ostream &os, const Program &program)
+{
+    os << "Z " << (program.program.isMax ? "max" : "min") << " = Z(";
+    for (size_t j = 0; j < program.solution.size(); ++j)
+    {
+        os << (j ? "; " : "") << program.solution[j];
+    }
+    os << ") = " << program.objective << "\n";
+    os << "Dual(";
+    for (size_t i = 0; i < program.dual.size(); ++i)
+    {
+        os << (i ? "; " : "") << program.dual[i];
+    }
+    os << ") * b = " << program.objective << "\n";
+}
+
+void writeAnswer(std::ostream &os, const Transport &transport)
+{
+    os << "Result = " << transport.cost << "\n";
+    for (const auto &row : transport.plan)
+    {
+        for (size_t j = 0; j < row.size(); ++j)
+        {
+            os << (j ? " " : "") << row[j];
+        }
+        os << "\n";
+    }
+}
+
+}
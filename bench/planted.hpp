@@ -0,0 +1,52 @@
+#pragma once
+#include "generators.hpp"
+#include <iosfwd>
+#include <random>
+#include <vector>
+
+// Instances with a known answer, built backwards from the answer.
+namespace planted
+{
+
+// A * x = b with A = P * L * U for unit triangular L, U, so det A = ±1 and
+// the planted x is the only solution.
+struct System
+{
+    generators::LinearSystem system;
+    std::vector<Fraction> solution;
+};
+
+// max/min c * x, A x <= b (some rows flipped to >=), x >= 0, with a
+// non-degenerate optimal vertex x and a strictly complementary dual y.
+struct Program
+{
+    generators::LinearProgram program;
+    std::vector<Fraction> solution;
+    std::vector<Fraction> dual;
+    Fraction objective;
+};
+
+// Costs c_ij = u_i + v_j on a random spanning tree of cells and
+// u_i + v_j + d_ij (d_ij > 0) elsewhere, so the positive flow on the tree is
+// the unique optimal plan.
+struct Transport
+{
+    generators::TransportProblem problem;
+    std::vector<std::vector<unsigned long long>> plan;
+    unsigned long long cost = 0;
+};
+
+System plantedSystem(int n, std::mt19937_64 &rng);
+Program plantedProgram(int rows, int columns, std::mt19937_64 &rng);
+Transport plantedTransport(int rows, int columns, std::mt19937_64 &rng);
+
+// Writers for the input formats of ./main, simplex/main and 3lab/main, and
+// for the matching expected-answer files.
+void writeInput(std::ostream &os, const generators::LinearSystem &system);
+void writeInput(std::ostream &os, const generators::LinearProgram &program);
+void writeInput(std::ostream &os, const generators::TransportProblem &problem);
+void writeAnswer(std::ostream &os, const System &system);
+void writeAnswer(std::ostream &os, const Program &program);
+void writeAnswer(std::ostream &os, const Transport &transport);
+
+}
@@ -0,0 +1,170 @@
+#include "checkpoint.hpp"
+#include <cstdio>
+#include <fstream>
+
+namespace checkpoint
+{
+
+void Writer::put(long long value)
+{
+    out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void Writer::put(const std::string &value)
+{
+    put((long long)value.size());
+    out.write(value.data(), value.size());
+}
+
+void Writer::put(const Fraction &value)
+{
+    long long pair[2] = {value.numerator, value.denominator};
+    out.write(reinterpret_cast<const char *>(pair), sizeof(pair));
+}
+
+void Writer::put(const Row &row)
+{
+    row.write(out);
+}
+
+void Writer::put(const Stats &stats)
+{
+    put(stats.pivots);
+    put(stats.iterations);
+    put(stats.bitGrowth);
+    put((long long)stats.peakBits);
+}
+
+void Reader::get(long long &value)
+{
+    good = good && in.read(reinterpret_cast<char *>(&value), sizeof(value));
+}
+
+void Reader::get(int &value)
+{
+    long long wide = 0;
+    get(wide);
+    value = wide;
+}
+
+void Reader::get(bool &value)
+{
+    long long wide = 0;
+    get(wide);
+    value = wide != 0;
+}
+
+void Reader::get(std::string &value)
+{
+    long long size = -1;
+    get(size);
+    good = good && size >= 0 && size <= (1 << 20);
+    value.assign(good ? size : 0, ' ');
+    good = good && in.read(&value[0], value.size());
+}
+
+void Reader::get(Fraction &value)
+{
+    long long pair[2];
+    good = good && in.read(reinterpret_cast<char *>(pair), sizeof(pair)) && pair[1] > 0;
+    if (good)
+    {
+        value.numerator = pair[0];
+        value.denominator = pair[1];
+    }
+}
+
+void Reader::get(Row &row)
+{
+    good = good && row.read(in);
+}
+
+void Reader::get(Stats &stats)
+{
+    get(stats.pivots);
+    get(stats.iterations);
+    get(stats.bitGrowth);
+    get(stats.peakBits);
+}
+
+void Reader::get(std::vector<bool> &values)
+{
+    std::vector<int> wide;
+    get(wide);
+    values.assign(wide.begin(), wide.end());
+}
+
+bool Reader::expect(const std::string &tag)
+{
+    std::string found;
+    get(found);
+    return good = good && found == tag;
+}
+
+void Hash::add(long long item)
+{
+    for (int k = 0; k < 8; ++k)
+    {
+        value ^= (unsigned long long)item >> (8 * k) & 0xff;
+        value *= 1099511628211ull;
+    }
+}
+
+void Hash::add(const std::string &item)
+{
+    add((long long)item.size());
+    for (unsigned char c : item)
+    {
+        value ^= c;
+        value *= 1099511628211ull;
+    }
+}
+
+void Hash::add(const Fraction &item)
+{
+    add(item.numerator);
+    add(item.denominator);
+}
+
+void Hash::add(const Row &row)
+{
+    add((long long)row.size());
+    add(row.denominator());
+    for (int j = 0; j < row.size(); ++j)
+        add(row.value(j));
+}
+
+void Schedule::set(const std::string &path, double seconds)
+{
+    this->path = path;
+    interval = std::chrono::duration<double>(seconds);
+    next = {};
+}
+
+bool Schedule::due()
+{
+    if (path.empty())
+        return false;
+    auto now = std::chrono::steady_clock::now();
+    if (next == std::chrono::steady_clock::time_point{})
+        next = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(interval);
+    if (now < next)
+        return false;
+    next = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(interval);
+    return true;
+}
+
+bool Schedule::save(const std::function<void(Writer &)> &write) const
+{
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        Writer writer(out);
+        write(writer);
+        if (!out.flush())
+            return false;
+    }
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+}
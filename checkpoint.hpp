@@ -0,0 +1,107 @@
+#pragma once
+#include "fraction.hpp"
+#include "result.hpp"
+#include "row.hpp"
+#include <chrono>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// Snapshots of a long solve, so that a restarted process goes on from the
+// last one instead of from the start. A file is a tag naming the solver and
+// its fields as raw integers in the byte order of the machine; rows go out
+// as their int32 or int64 arrays in one block, so writing one costs about
+// as much as copying the tableau.
+namespace checkpoint
+{
+
+class Writer
+{
+private:
+    std::ostream &out;
+
+public:
+    explicit Writer(std::ostream &out) : out(out) {}
+    void put(long long value);
+    void put(const std::string &value);
+    void put(const Fraction &value);
+    void put(const Row &row);
+    void put(const Stats &stats);
+    template <class T>
+    void put(const std::vector<T> &values)
+    {
+        put((long long)values.size());
+        for (const T &it : values)
+            put(it);
+    }
+};
+
+// Reads what a Writer wrote; after the first short read or implausible
+// size everything fails.
+class Reader
+{
+private:
+    std::istream &in;
+    bool good = true;
+
+public:
+    explicit Reader(std::istream &in) : in(in) {}
+    explicit operator bool() const { return good; }
+    void get(long long &value);
+    void get(int &value);
+    void get(bool &value);
+    void get(std::string &value);
+    void get(Fraction &value);
+    void get(Row &row);
+    void get(Stats &stats);
+    void get(std::vector<bool> &values);
+    template <class T>
+    void get(std::vector<T> &values)
+    {
+        long long size = -1;
+        get(size);
+        good = good && size >= 0 && size <= (1 << 30);
+        values.assign(good ? size : 0, T());
+        for (T &it : values)
+            get(it);
+    }
+    // Reads the tag and checks it is the expected one.
+    bool expect(const std::string &tag);
+};
+
+// FNV-1a over the input of a problem. A snapshot carries the hash of the
+// problem it was taken from, and resume() turns down one that was taken
+// from another problem of the same shape.
+class Hash
+{
+private:
+    unsigned long long value = 14695981039346656037ull;
+
+public:
+    void add(long long item);
+    void add(const std::string &item);
+    void add(const Fraction &item);
+    void add(const Row &row);
+    unsigned long long get() const { return value; }
+};
+
+// When the next snapshot is due. A schedule without a path never is.
+class Schedule
+{
+private:
+    std::string path;
+    std::chrono::duration<double> interval{5};
+    std::chrono::steady_clock::time_point next;
+
+public:
+    void set(const std::string &path, double seconds);
+    bool enabled() const { return !path.empty(); }
+    // True at most once per interval; the clock starts with the first call.
+    bool due();
+    // Writes through a temporary file renamed over the path, so a crash in
+    // the middle leaves the previous snapshot in place.
+    bool save(const std::function<void(Writer &)> &write) const;
+};
+
+}
@@ -0,0 +1,268 @@
+#include "counters.hpp"
+#include "result.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <vector>
+#ifdef ALGOM_COUNTERS
+#include <atomic>
+#include <mutex>
+#endif
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef ALGOM_COUNTERS
+namespace counters
+{
+thread_local unsigned long long gcdCalls = 0;
+thread_local unsigned long long fractions = 0;
+thread_local unsigned long long promotions = 0;
+thread_local unsigned long long allocations = 0;
+thread_local unsigned long long bytesAllocated = 0;
+thread_local void (*fractionHook)(char op, const Fraction &lhs, const Fraction &rhs) = nullptr;
+
+static std::atomic<unsigned long long> mergedGcdCalls{0}, mergedFractions{0}, mergedPromotions{0}, mergedAllocations{0},
+    mergedBytes{0};
+
+struct PhaseTime
+{
+    const char *name;
+    double ms;
+    long long calls;
+};
+
+static std::mutex phaseMutex;
+static std::vector<PhaseTime> phases;
+
+Totals totals()
+{
+    Totals result;
+    result.gcdCalls = mergedGcdCalls + gcdCalls;
+    result.fractions = mergedFractions + fractions;
+    result.promotions = mergedPromotions + promotions;
+    result.allocations = mergedAllocations + allocations;
+    result.bytesAllocated = mergedBytes + bytesAllocated;
+    return result;
+}
+
+void mergeThread()
+{
+    mergedGcdCalls += gcdCalls;
+    mergedFractions += fractions;
+    mergedPromotions += promotions;
+    mergedAllocations += allocations;
+    mergedBytes += bytesAllocated;
+    gcdCalls = fractions = promotions = allocations = bytesAllocated = 0;
+}
+
+void reset()
+{
+    mergedGcdCalls = mergedFractions = mergedPromotions = mergedAllocations = mergedBytes = 0;
+    gcdCalls = fractions = promotions = allocations = bytesAllocated = 0;
+    std::lock_guard<std::mutex> lock(phaseMutex);
+    phases.clear();
+}
+
+Phase::~Phase()
+{
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::lock_guard<std::mutex> lock(phaseMutex);
+    for (auto &it : phases)
+    {
+        if (std::strcmp(it.name, name) == 0)
+        {
+            it.ms += ms;
+            it.calls++;
+            return;
+        }
+    }
+    phases.push_back({name, ms, 1});
+}
+}
+
+// Every allocation of an instrumented build is counted on the allocating thread.
+void *operator new(std::size_t size)
+{
+    counters::bytesAllocated += size;
+    counters::allocations++;
+    if (void *ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+#endif
+
+namespace counters
+{
+
+struct Hardware
+{
+    const char *name;
+    int fd;
+};
+
+static Hardware hardware[] = {{"cycles", -1}, {"cache_misses", -1}, {"branch_misses", -1}};
+static std::chrono::steady_clock::time_point startTime;
+
+void start()
+{
+#ifdef ALGOM_COUNTERS
+    reset();
+#endif
+#ifdef __linux__
+    const unsigned long long configs[] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+    for (int i = 0; i < 3; ++i)
+    {
+        Hardware &it = hardware[i];
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = configs[i];
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        it.fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (it.fd != -1)
+        {
+            ioctl(it.fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(it.fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+    startTime = std::chrono::steady_clock::now();
+}
+
+// Reads a hardware counter, or returns false when it could not be opened.
+static bool readHardware(Hardware &counter, unsigned long long &value)
+{
+#ifdef __linux__
+    if (counter.fd == -1)
+        return false;
+    ioctl(counter.fd, PERF_EVENT_IOC_DISABLE, 0);
+    long long count = 0;
+    bool valid = read(counter.fd, &count, sizeof(count)) == sizeof(count);
+    close(counter.fd);
+    counter.fd = -1;
+    value = count;
+    return valid;
+#else
+    return false;
+#endif
+}
+
+void report(std::ostream &out, const std::string &format, const Stats &stats)
+{
+    double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    std::vector<std::pair<const char *, unsigned long long>> measured;
+    for (auto &it : hardware)
+    {
+        unsigned long long value = 0;
+        if (readHardware(it, value))
+            measured.push_back({it.name, value});
+    }
+    bool json = format == "json";
+    if (json)
+    {
+        out << "{\"pivots\": " << stats.pivots << ", \"iterations\": " << stats.iterations << ", \"bit_growth\": " << stats.bitGrowth
+            << ", \"peak_bits\": " << stats.peakBits << ", \"wall_ms\": " << wallMs;
+    }
+    else
+    {
+        out << "Stats:" << std::endl
+            << "  pivots " << stats.pivots << ", iterations " << stats.iterations << ", coefficient growth " << stats.bitGrowth
+            << " bits, peak row height " << stats.peakBits << " bits" << std::endl
+            << "  wall time " << wallMs << " ms" << std::endl;
+    }
+#ifdef ALGOM_COUNTERS
+    Totals counted = totals();
+    std::vector<PhaseTime> timed;
+    {
+        std::lock_guard<std::mutex> lock(phaseMutex);
+        timed = phases;
+    }
+    if (json)
+    {
+        out << ", \"counters\": {\"gcd_calls\": " << counted.gcdCalls << ", \"fractions\": " << counted.fractions
+            << ", \"promotions\": " << counted.promotions << ", \"allocations\": " << counted.allocations
+            << ", \"bytes_allocated\": " << counted.bytesAllocated << "}, \"phases\": [";
+        for (int i = 0; i < timed.size(); ++i)
+        {
+            out << (i ? ", " : "") << "{\"name\": \"" << timed[i].name << "\", \"ms\": " << timed[i].ms << ", \"calls\": " << timed[i].calls
+                << "}";
+        }
+        out << "]";
+    }
+    else
+    {
+        out << "  gcd calls " << counted.gcdCalls << ", Fractions " << counted.fractions << ", row promotions " << counted.promotions
+            << ", allocations " << counted.allocations << " (" << counted.bytesAllocated << " bytes)" << std::endl;
+        for (auto &it : timed)
+        {
+            out << "  " << std::left << std::setw(20) << it.name << std::right << it.ms << " ms in " << it.calls
+                << (it.calls == 1 ? " call" : " calls") << std::endl;
+        }
+    }
+#else
+    if (json)
+        out << ", \"counters\": null, \"phases\": null";
+    else
+        out << "  counters and phase times are compiled out, configure with -DALGOM_COUNTERS=ON" << std::endl;
+#endif
+    if (json)
+    {
+        out << ", \"hardware\": ";
+        if (measured.empty())
+            out << "null";
+        for (int i = 0; i < measured.size(); ++i)
+        {
+            out << (i ? ", " : "{") << "\"" << measured[i].first << "\": " << measured[i].second;
+        }
+        out << (measured.empty() ? "" : "}") << "}" << std::endl;
+    }
+    else if (measured.empty())
+        out << "  hardware counters are unavailable (perf_event_open)" << std::endl;
+    else
+    {
+        out << " ";
+        for (auto &it : measured)
+        {
+            out << " " << it.first << " " << it.second;
+        }
+        out << std::endl;
+    }
+}
+
+}
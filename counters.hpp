@@ -0,0 +1,72 @@
+#pragma once
+#include <iosfwd>
+#include <string>
+
+struct Stats;
+
+// Hot-path counters and phase timers. Only builds with ALGOM_COUNTERS (the
+// benchmarks, or cmake -DALGOM_COUNTERS=ON for the library and the tools)
+// count anything; elsewhere the ALGOM_ macros compile to nothing.
+#ifdef ALGOM_COUNTERS
+#include <chrono>
+class Fraction;
+namespace counters
+{
+extern thread_local unsigned long long gcdCalls;
+extern thread_local unsigned long long fractions;
+extern thread_local unsigned long long promotions;
+extern thread_local unsigned long long allocations;
+extern thread_local unsigned long long bytesAllocated;
+// Called with every binary Fraction operation when set; used to capture
+// realistic operand streams from the solvers.
+extern thread_local void (*fractionHook)(char op, const Fraction &lhs, const Fraction &rhs);
+
+struct Totals
+{
+    unsigned long long gcdCalls = 0;
+    unsigned long long fractions = 0;
+    unsigned long long promotions = 0;
+    unsigned long long allocations = 0;
+    unsigned long long bytesAllocated = 0;
+};
+
+// Counts of the threads that called mergeThread() plus the calling thread.
+Totals totals();
+// Moves the calling thread's counts into the process totals. Worker
+// threads call it before they finish, or their counts are lost.
+void mergeThread();
+// Zeroes the process totals, the calling thread's counts and the phases.
+void reset();
+
+// Adds the time from construction to destruction to the named phase.
+class Phase
+{
+private:
+    const char *name;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit Phase(const char *name) : name(name), start(std::chrono::steady_clock::now()) {}
+    ~Phase();
+};
+}
+#define ALGOM_COUNT(counter) (++counters::counter)
+#define ALGOM_TRACE(op, lhs, rhs) (counters::fractionHook ? counters::fractionHook(op, lhs, rhs) : (void)0)
+#define ALGOM_PHASE(name) counters::Phase algomPhase(name)
+#define ALGOM_MERGE_THREAD() counters::mergeThread()
+#else
+#define ALGOM_COUNT(counter) ((void)0)
+#define ALGOM_TRACE(op, lhs, rhs) ((void)0)
+#define ALGOM_PHASE(name) ((void)0)
+#define ALGOM_MERGE_THREAD() ((void)0)
+#endif
+
+namespace counters
+{
+// Zeroes the counters and starts the wall clock and, where perf_event_open
+// allows it, the hardware counters. The tools call it for --stats.
+void start();
+// Prints the solver stats and whatever this build measured since start(),
+// as "text" or "json".
+void report(std::ostream &out, const std::string &format, const Stats &stats);
+}
@@ -1,13 +1,22 @@
 #include "fraction.hpp"
+#include "counters.hpp"
+#include <iostream>
 #include <numeric>
+#include <stdexcept>
 #include <string>
 
+static long long gcd(long long a, long long b)
+{
+    ALGOM_COUNT(gcdCalls);
+    return std::gcd(a, b);
+}
+
 Fraction::Fraction(long long n, long long d)
 {
+    ALGOM_COUNT(fractions);
     if (d == 0)
     {
-        std::cerr << "Denominator may not be 0." << std::endl;
-        exit(0);
+        throw std::domain_error("Denominator may not be 0.");
     }
     if (n == 0)
     {
@@ -36,18 +45,20 @@ void Fraction::calculateGcd()
         denominator *= -1;
     }
 
-    long long tmp = std::gcd(numerator, denominator);
+    long long tmp = gcd(numerator, denominator);
     numerator = numerator / tmp * sign;
     denominator = denominator / tmp;
 }
 
 Fraction Fraction::operator+(const Fraction &other) const
 {
+    ALGOM_TRACE('+', *this, other);
     return Fraction{numerator * other.denominator + other.numerator * denominator, denominator * other.denominator};
 }
 
 Fraction &Fraction::operator+=(const Fraction &other)
 {
+    ALGOM_TRACE('+', *this, other);
     Fraction tmp = Fraction{numerator * other.denominator + other.numerator * denominator, denominator * other.denominator};
     *this = tmp;
     return *this;
@@ -55,6 +66,7 @@ Fraction &Fraction::operator+=(const Fraction &other)
 
 Fraction Fraction::operator-(const Fraction &other) const
 {
+    ALGOM_TRACE('-', *this, other);
     return Fraction{numerator * other.denominator - other.numerator * denominator, denominator * other.denominator};
 }
 
@@ -64,6 +76,7 @@ Fraction Fraction::operator-() const{
 
 Fraction &Fraction::operator-=(const Fraction &other)
 {
+    ALGOM_TRACE('-', *this, other);
     Fraction tmp = Fraction{numerator * other.denominator - other.numerator * denominator, denominator * other.denominator};
     *this = tmp;
     return *this;
@@ -71,22 +84,24 @@ Fraction &Fraction::operator-=(const Fraction &other)
 
 Fraction Fraction::operator*(const Fraction &other) const
 {
-    int del = std::gcd(other.numerator, denominator);
-    int del2 = std::gcd(numerator, other.denominator);
+    ALGOM_TRACE('*', *this, other);
+    int del = gcd(other.numerator, denominator);
+    int del2 = gcd(numerator, other.denominator);
     return Fraction{(numerator/del2) * (other.numerator/del), (denominator/del) * (other.denominator/del2)};
 }
 
 Fraction &Fraction::operator*=(const Fraction &other)
 {
-    int del = std::gcd(other.numerator, denominator);
-    int del2 = std::gcd(numerator, other.denominator);
+    ALGOM_TRACE('*', *this, other);
+    int del = gcd(other.numerator, denominator);
+    int del2 = gcd(numerator, other.denominator);
     *this = Fraction{(numerator/del2) * (other.numerator/del), (denominator/del) * (other.denominator/del2)};
     return *this;
 }
 
 Fraction &Fraction::operator*=(const int &other)
 {   
-    int del = std::gcd(other, denominator);
+    int del = gcd(other, denominator);
     Fraction tmp = Fraction{numerator * (other / del), denominator / del};
     *this = tmp;
     return *this;
@@ -94,24 +109,26 @@ Fraction &Fraction::operator*=(const int &other)
 
 Fraction Fraction::operator/(const Fraction &other) const
 {
+    ALGOM_TRACE('/', *this, other);
     if (numerator == 0) return Fraction{0};
-    int del = std::gcd(other.denominator, denominator);
-    int del2 = std::gcd(other.numerator, numerator);
+    int del = gcd(other.denominator, denominator);
+    int del2 = gcd(other.numerator, numerator);
     return Fraction{(numerator/del2) * (other.denominator/del), (denominator/del) * (other.numerator/del2)};
 }
 
 Fraction &Fraction::operator/=(const Fraction &other)
 {
+    ALGOM_TRACE('/', *this, other);
     if (numerator == 0) *this = Fraction{0};
-    int del = std::gcd(other.denominator, denominator);
-    int del2 = std::gcd(other.numerator, numerator);
+    int del = gcd(other.denominator, denominator);
+    int del2 = gcd(other.numerator, numerator);
     *this = Fraction{(numerator/del2) * (other.denominator/del), (denominator/del) * (other.numerator/del2)};
     return *this;
 }
 
 Fraction &Fraction::operator/=(const int &other)
 {   
-    int del = std::gcd(other, numerator);
+    int del = gcd(other, numerator);
     Fraction tmp = Fraction{numerator / del, denominator * (other / del)};
     *this = tmp;
     return *this;
@@ -134,10 +151,10 @@ bool Fraction::operator>(const Fraction &other) const
 
 std::ostream &operator<<(std::ostream &os, const Fraction &dt)
 {
+    std::string number = std::to_string(dt.numerator);
     if (dt.denominator != 1)
-        os << dt.numerator << '/' << dt.denominator;
-    else
-        os << dt.numerator;
+        number += "/" + std::to_string(dt.denominator);
+    os << number;
     return os;
 }
 
@@ -155,6 +172,8 @@ std::istream &operator>>(std::istream &is, Fraction &dt)
     {
         dt.numerator = std::stoll(str.substr(0, pos));
         dt.denominator = std::stoll(str.substr(pos + 1));
+        if (dt.denominator == 0)
+            throw std::domain_error("Denominator may not be 0.");
         dt.calculateGcd();
     }
     return is;
@@ -1,11 +1,14 @@
-#include <iostream>
+#pragma once
+#include "counters.hpp"
+#include <iosfwd>
 
 class Fraction {
     public:
         long long numerator, denominator;
 
-        Fraction() : numerator(0), denominator(1) {}
-        Fraction(long long n) : numerator(n), denominator(1) {}
+        Fraction() : numerator(0), denominator(1) { ALGOM_COUNT(fractions); }
+        Fraction(long long n) : numerator(n), denominator(1) { ALGOM_COUNT(fractions); }
+        // Throws std::domain_error when d is 0.
         Fraction(long long n, long long d);
 
         void calculateGcd();
@@ -0,0 +1,448 @@
+#include "gauss.hpp"
+#include "counters.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+namespace gauss
+{
+
+Matrix::Matrix(std::istream &in)
+{
+    in >> n >> m;
+    std::vector<Fraction> row(m);
+    for (int i = 0; i < n; ++i)
+    {
+        // >> leaves the denominator alone on an integer, so every cell
+        // starts from a fresh Fraction.
+        for (auto &num : row)
+        {
+            Fraction value;
+            in >> value;
+            num = value;
+        }
+        matrix.push_back(Row(row));
+    }
+    inputHash = hashInput();
+}
+
+Matrix::Matrix(const std::vector<std::vector<Fraction>> &augmented) : matrix(augmented.begin(), augmented.end())
+{
+    n = matrix.size();
+    m = n ? matrix[0].size() : 0;
+    inputHash = hashInput();
+}
+
+unsigned long long Matrix::hashInput() const
+{
+    checkpoint::Hash hash;
+    hash.add(n);
+    hash.add(m);
+    for (const auto &row : matrix)
+        hash.add(row);
+    return hash.get();
+}
+
+std::ostream &Matrix::log() const
+{
+    thread_local std::ostream nullStream(nullptr);
+    return out ? *out : nullStream;
+}
+
+void Matrix::printMatrix() const
+{
+    if (!out)
+        return;
+    for (const auto &row : matrix)
+    {
+        for (int j = 0; j < m; ++j)
+        {
+            log() << row[j] << " ";
+        }
+        log() << std::endl;
+    }
+}
+
+bool Matrix::checkZero(int i, int j)
+{
+    while (i < n)
+    {
+        if (!matrix[i].isZero(j))
+            return false;
+        ++i;
+    }
+    return true;
+}
+
+bool Matrix::setPivot(const std::string &rule)
+{
+    if (rule != "largest" && rule != "height")
+        return false;
+    pivot = rule;
+    growthReport = true;
+    return true;
+}
+
+void Matrix::setMaxElement(int starti, int j)
+{
+    int swapPos = -1;
+    if (pivot == "height")
+    {
+        int best = starti;
+        for (int i = starti + 1; i < n; ++i)
+        {
+            if (!matrix[i].isZero(j) && (matrix[best].isZero(j) || lighterPivot(matrix[i], j, matrix[best], j)))
+                best = i;
+        }
+        if (best != starti)
+            std::swap(matrix[starti], matrix[best]);
+        return;
+    }
+    Fraction mmax = Fraction::abs(matrix[starti][j]);
+    for (int i = starti + 1; i < n; ++i)
+    {
+        if (Fraction::abs(matrix[i][j]) > mmax)
+        {
+            mmax = Fraction::abs(matrix[i][j]);
+            swapPos = i;
+        }
+    }
+    if (swapPos != -1)
+        std::swap(matrix[starti], matrix[swapPos]);
+}
+
+bool Matrix::noSolutions()
+{
+    for (int i = n - 1; i > -1; --i)
+    {
+        if (matrix[i][m - 1].numerator != 0)
+        {
+            bool isZero = true;
+            for (int j = 0; j < m - 1; ++j)
+            {
+                if (matrix[i][j].numerator != 0)
+                {
+                    isZero = false;
+                    break;
+                }
+            }
+            if (isZero)
+                return true;
+        }
+    }
+    return false;
+}
+
+int Matrix::getMatrixSize() const
+{
+    return matrix_size;
+}
+
+std::vector<std::vector<int>> Matrix::basisPositions()
+{
+    auto nextSet = [](std::vector<int> &a, int n, int m)
+    {
+        int k = m;
+        for (int i = k - 1; i >= 0; --i)
+            if (a[i] < n - k + i + 1)
+            {
+                ++a[i];
+                for (int j = i + 1; j < k; ++j)
+                    a[j] = a[j - 1] + 1;
+                return true;
+            }
+        return false;
+    };
+
+    std::vector<std::vector<int>> vec;
+    if (m - 1 >= matrix_size)
+    {
+        std::vector<int> tmp(matrix_size);
+        for (int i = 0; i < matrix_size; ++i)
+        {
+            tmp[i] = i;
+        }
+        vec.push_back(tmp);
+        while (nextSet(tmp, m - 2, matrix_size))
+            vec.push_back(tmp);
+    }
+    return vec;
+}
+
+void Matrix::printOneBasis(const std::vector<int> &basis) const
+{
+    log() << "{ ";
+    for (int i = 0; i < basis.size() - 1; ++i)
+    {
+        log() << "x" << basis[i] + 1 << "; ";
+    }
+    log() << "x" << basis.back() + 1 << " }   ";
+}
+
+std::vector<BasicSolution> Matrix::Basises()
+{
+    ALGOM_PHASE("Basises");
+    std::vector<BasicSolution> result;
+    if (noSolution)
+    {
+        log() << "The matrix has no solutions, so you cannot use the search for basic solutions" << std::endl;
+        return result;
+    }
+    if (nextBasis == 0 || positions.empty())
+    {
+        positions = basisPositions();
+        if (nextBasis == 0)
+            log() << "SIZE = " << positions.size() << std::endl;
+        else
+            log() << "SIZE = " << positions.size() << ", resuming at basis " << nextBasis + 1 << std::endl;
+    }
+    Deadline deadline(budget);
+    std::vector<Row> startVec;
+    for (; nextBasis < positions.size(); ++nextBasis)
+    {
+        if (!result.empty() && deadline.exhausted())
+        {
+            log() << "\033[33mStopped by the budget after " << nextBasis << " of " << positions.size()
+                  << " bases, Basises() resumes from here\033[0m" << std::endl;
+            if (snapshots.enabled())
+                saveCheckpoint();
+            return result;
+        }
+        if (snapshots.due())
+            saveCheckpoint();
+        const std::vector<int> &basisItem = positions[nextBasis];
+        std::vector<std::vector<int>> isUsed(matrix_size, std::vector<int>());
+        startVec.assign(matrix.begin(), matrix.begin() + matrix_size);
+        bool flag = true;
+        for (int row = 0; row < matrix_size; ++row)
+        {
+            for (auto &it : basisItem)
+            {
+                if (!startVec[row].isZero(it))
+                {
+                    isUsed[row].push_back(it);
+                }
+            }
+            if (isUsed[row].size() == 0)
+            {
+                flag = false;
+                break;
+            }
+            if (isUsed[row].size() == 1)
+            {
+                for (int i = 0; i < row; ++i)
+                {
+                    auto it = std::find(isUsed[i].begin(), isUsed[i].end(), isUsed[row][0]);
+                    if (it != isUsed[i].end())
+                        isUsed[i].erase(std::find(isUsed[i].begin(), isUsed[i].end(), isUsed[row][0]));
+                    if (isUsed[i].size() == 0) {
+                        flag = false;
+                        break;
+                    }
+                }
+            }
+        }
+        if (!flag)
+        {
+            result.push_back({basisItem, false, {}});
+            printOneBasis(basisItem);
+            log() << "NO BASIS" << std::endl;
+            continue;
+        }
+        for (int row = 0; row < matrix_size; ++row)
+        {
+            if (isUsed[row].size() > 1)
+            {
+                int num = isUsed[row][0];
+                isUsed[row].clear();
+                isUsed[row].push_back(num);
+                for (int i = row + 1; i < matrix_size; ++i)
+                {
+                    auto it = std::find(isUsed[i].begin(), isUsed[i].end(), num);
+                    if (it != isUsed[i].end())
+                        isUsed[i].erase(std::find(isUsed[i].begin(), isUsed[i].end(), num));
+                }
+            }
+        }
+        for (int row = 0; row < matrix_size; ++row)
+        {
+            Fraction del = startVec[row][isUsed[row][0]];
+            if (del.numerator == 0)
+            {
+                flag = false;
+                break;
+            }
+            startVec[row].divide(del);
+            for (int i = 0; i < matrix_size; ++i)
+            {
+                if (i != row)
+                    startVec[i].eliminate(startVec[row], isUsed[row][0]);
+            }
+        }
+        if (!flag)
+        {
+            result.push_back({basisItem, false, {}});
+            printOneBasis(basisItem);
+            log() << "NO BASIS" << std::endl;
+            continue;
+        }
+        std::vector<Fraction> res(m - 1, 0);
+        for (auto &it : basisItem)
+        {
+            for (int i = 0; i < matrix_size; ++i)
+            {
+                if (isUsed[i][0] == it)
+                {
+                    res[it] = startVec[i][m - 1];
+                    break;
+                }
+            }
+        }
+        result.push_back({basisItem, true, res});
+        printOneBasis(basisItem);
+        log() << "{ ";
+        for (int i = 0; i < m - 2; ++i)
+        {
+            log() << res[i] << "; ";
+        }
+        log() << res.back() << " }" << std::endl;
+    }
+    nextBasis = 0;
+    return result;
+}
+
+void Matrix::saveCheckpoint() const
+{
+    ALGOM_PHASE("checkpoint");
+    bool saved = snapshots.save([this](checkpoint::Writer &out)
+                                {
+                                    out.put("algom-gauss 2");
+                                    out.put((long long)inputHash);
+                                    out.put(matrix_size);
+                                    out.put(noSolution);
+                                    out.put(matrix);
+                                    out.put(nextBasis);
+                                });
+    if (!saved)
+        log() << "\033[31mCould not write the checkpoint\033[0m" << std::endl;
+}
+
+bool Matrix::resume(std::istream &in)
+{
+    checkpoint::Reader reader(in);
+    long long hash = 0;
+    reader.expect("algom-gauss 2");
+    reader.get(hash);
+    if (!reader || (unsigned long long)hash != inputHash)
+        return false;
+    reader.get(matrix_size);
+    reader.get(noSolution);
+    reader.get(matrix);
+    reader.get(nextBasis);
+    if (!reader || matrix_size > matrix.size() || nextBasis < 0)
+        return false;
+    positions.clear();
+    return true;
+}
+
+Result Matrix::JordanGauss()
+{
+    ALGOM_PHASE("JordanGauss");
+    Result result;
+    int row = 0;
+    int column = 0;
+
+    log() << "Start matrix:" << std::endl;
+    printMatrix();
+    log() << std::endl;
+    for (; row < n && column < m - 1; ++row, ++column)
+    {
+        while (checkZero(row, column) && column < m - 1)
+        {
+            column++;
+            log() << "Column " << column << " only zero!" << std::endl;
+        }
+        if (column == m - 1)
+        {
+            break;
+        }
+        setMaxElement(row, column);
+        stats.pivots++;
+        log() << "Set max element at " << row << " " << column << std::endl;
+        printMatrix();
+        log() << std::endl;
+        int before = matrix[row].height();
+        matrix[row].divide(matrix[row][column]);
+        stats.recordHeight(before, matrix[row].height());
+        log() << "Change line " << row << std::endl;
+        printMatrix();
+        log() << std::endl;
+        for (int i = 0; i < n; ++i)
+        {
+            if (i == row)
+                continue;
+            int before = matrix[i].height();
+            matrix[i].eliminate(matrix[row], column);
+            stats.recordHeight(before, matrix[i].height());
+        }
+        log() << "Zeroing a column " << column << std::endl;
+        printMatrix();
+        log() << std::endl;
+    }
+    if (growthReport)
+        log() << "Coefficient growth (" << pivot << " pivots): " << stats.bitGrowth << " bits over " << stats.pivots
+              << " pivots, peak row height " << stats.peakBits << " bits" << std::endl;
+
+    if (noSolutions())
+    {
+        log() << "The system has no solutions" << std::endl;
+        noSolution = true;
+        result.status = Status::Infeasible;
+        result.stats = stats;
+        return result;
+    }
+    else
+    {
+        log() << "Solution:" << std::endl;
+        result.solution.assign(m - 1, Fraction(0));
+        for (int i = 0, j = 0; i < n && j < m - 1; ++i, ++j)
+        {
+            if (matrix[i][j] == Fraction{1})
+            {
+                bool flag = true;
+                if (matrix[i][m - 1].numerator != 0)
+                {
+                    log() << "x" << j + 1 << " = " << matrix[i][m - 1] << " ";
+                    flag = false;
+                }
+                else
+                    log() << "x" << j + 1 << " = ";
+                for (int tmp = j + 1; tmp < m - 1; ++tmp)
+                {
+                    if (matrix[i][tmp].numerator != 0)
+                    {
+                        flag = false;
+                        log() << (matrix[i][tmp].numerator < 0 ? "+ " : "- ");
+                        log() << Fraction::abs(matrix[i][tmp]) << "(x" << tmp + 1 << ") ";
+                    }
+                }
+                if (flag)
+                    log() << "0";
+                log() << std::endl;
+                result.basis.push_back(j);
+                result.solution[j] = matrix[i][m - 1];
+                matrix_size++;
+            }
+            else
+            {
+                i--;
+            }
+        }
+    }
+    result.rank = matrix_size;
+    result.stats = stats;
+    return result;
+}
+
+}
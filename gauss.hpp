@@ -0,0 +1,82 @@
+#pragma once
+#include "checkpoint.hpp"
+#include "fraction.hpp"
+#include "result.hpp"
+#include "row.hpp"
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace gauss
+{
+
+struct Result
+{
+    Status status = Status::Optimal;
+    int rank = 0;
+    std::vector<int> basis;
+    std::vector<Fraction> solution;
+    Stats stats;
+};
+
+struct BasicSolution
+{
+    std::vector<int> basis;
+    bool exists = false;
+    std::vector<Fraction> solution;
+};
+
+class Matrix
+{
+private:
+    int n, m;
+    int matrix_size = 0;
+    bool noSolution = false;
+    std::vector<Row> matrix;
+    std::string pivot = "largest";
+    bool growthReport = false;
+    Budget budget;
+    // The bases Basises() enumerates and the next one to try when it stopped.
+    std::vector<std::vector<int>> positions;
+    int nextBasis = 0;
+    checkpoint::Schedule snapshots;
+    // Of the matrix as it was read, before JordanGauss().
+    unsigned long long inputHash = 0;
+    std::ostream *out = nullptr;
+    Stats stats;
+
+    std::ostream &log() const;
+    void setMaxElement(int i, int j);
+    bool checkZero(int i, int j);
+    bool noSolutions();
+    void printOneBasis(const std::vector<int> &basis) const;
+    std::vector<std::vector<int>> basisPositions();
+    void saveCheckpoint() const;
+    unsigned long long hashInput() const;
+
+public:
+    Matrix(std::istream &in);
+    Matrix(const std::vector<std::vector<Fraction>> &augmented);
+    void setOutput(std::ostream *out) { this->out = out; }
+    // "largest" (the largest |value| in the column) or "height" (the pivot
+    // with the fewest bits, then the sparsest row).
+    bool setPivot(const std::string &rule);
+    // Prints the coefficient growth after JordanGauss(); setPivot() turns it
+    // on as well.
+    void setGrowthReport(bool report) { growthReport = report; }
+    // A budget stops the enumeration between bases; the next call returns
+    // the bases after the last one returned.
+    void setBudget(const Budget &budget) { this->budget = budget; }
+    // Saves the reduced matrix and the next basis to try to path every few
+    // seconds of Basises() and when the budget stops it; resume() loads such
+    // a file in place of JordanGauss(), and Basises() goes on from it.
+    void setCheckpoint(const std::string &path, double seconds) { snapshots.set(path, seconds); }
+    bool resume(std::istream &in);
+    std::vector<BasicSolution> Basises();
+    bool hasMoreBasises() const { return nextBasis > 0; }
+    int getMatrixSize() const;
+    void printMatrix() const;
+    Result JordanGauss();
+};
+
+}
@@ -0,0 +1,48 @@
+#include "result.hpp"
+#include <csignal>
+
+const char *statusName(Status status)
+{
+    switch (status)
+    {
+    case Status::Optimal:
+        return "optimal";
+    case Status::Feasible:
+        return "feasible";
+    case Status::Infeasible:
+        return "infeasible";
+    case Status::Unbounded:
+        return "unbounded";
+    case Status::Stopped:
+        return "stopped";
+    }
+    return "unknown";
+}
+
+Deadline::Deadline(const Budget &budget) : budget(budget)
+{
+    auto duration = std::chrono::duration<double>(budget.seconds);
+    end = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(duration);
+}
+
+bool Deadline::exhausted()
+{
+    long long step = ++steps;
+    if (budget.steps > 0 && step >= budget.steps)
+        return true;
+    if (budget.cancel && budget.cancel->load(std::memory_order_relaxed))
+        return true;
+    return budget.seconds > 0 && std::chrono::steady_clock::now() >= end;
+}
+
+static std::atomic<bool> interrupted{false};
+
+const std::atomic<bool> *cancelOnInterrupt()
+{
+    std::signal(SIGINT, [](int)
+                {
+                    interrupted = true;
+                    std::signal(SIGINT, SIG_DFL);
+                });
+    return &interrupted;
+}
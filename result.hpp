@@ -0,0 +1,64 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+
+// Feasible is a plan that is not proven optimal; Stopped is a solve that ran
+// out of budget before it had any plan.
+enum class Status
+{
+    Optimal,
+    Feasible,
+    Infeasible,
+    Unbounded,
+    Stopped
+};
+
+struct Stats
+{
+    long long pivots = 0;
+    long long iterations = 0;
+    // Bits the exact pivots added to the height of the rows they rewrote,
+    // summed over all pivots, and the largest row height seen.
+    long long bitGrowth = 0;
+    int peakBits = 0;
+
+    void recordHeight(int before, int after)
+    {
+        bitGrowth += after > before ? after - before : 0;
+        peakBits = after > peakBits ? after : peakBits;
+    }
+};
+
+const char *statusName(Status status);
+
+// Limits of one solve call, 0 meaning none. The solvers check them between
+// steps (simplex iterations, branch-and-bound nodes, transport iterations,
+// bases tried), stop at the first one that is hit and hand back the best
+// plan they have. Calling the solver again continues where it stopped.
+struct Budget
+{
+    double seconds = 0;
+    long long steps = 0;
+    // Set from any thread (or a signal handler) to stop at the next step.
+    const std::atomic<bool> *cancel = nullptr;
+};
+
+// A Budget counted from the start of one solve call; shared by the worker
+// threads of that call.
+class Deadline
+{
+private:
+    Budget budget;
+    std::chrono::steady_clock::time_point end;
+    std::atomic<long long> steps{0};
+
+public:
+    explicit Deadline(const Budget &budget);
+    // Counts one finished step and returns true once the budget is spent.
+    bool exhausted();
+};
+
+// Installs a SIGINT handler that raises the returned flag, so that Ctrl-C
+// stops a solve with the best plan found so far. A second Ctrl-C kills the
+// process as usual.
+const std::atomic<bool> *cancelOnInterrupt();
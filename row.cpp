@@ -0,0 +1,352 @@
+#include "row.hpp"
+#include "counters.hpp"
+#include <istream>
+#include <limits>
+#include <numeric>
+#include <ostream>
+#include <stdexcept>
+
+static long long gcd(long long a, long long b)
+{
+    ALGOM_COUNT(gcdCalls);
+    return std::gcd(a, b);
+}
+
+static bool fitsNarrow(long long value)
+{
+    return value >= std::numeric_limits<int32_t>::min() && value <= std::numeric_limits<int32_t>::max();
+}
+
+static long long magnitude(long long value)
+{
+    return value < 0 ? -value : value;
+}
+
+// The int64 products that can leave the range. A result of -2^63 counts as
+// an overflow too, so that every stored value can still be negated.
+static long long multiply(long long a, long long b)
+{
+    long long result;
+    if (__builtin_mul_overflow(a, b, &result) || result == std::numeric_limits<long long>::min())
+        throw std::overflow_error("A row of the tableau does not fit in 64-bit integers");
+    return result;
+}
+
+static long long subtract(long long a, long long b)
+{
+    long long result;
+    if (__builtin_sub_overflow(a, b, &result) || result == std::numeric_limits<long long>::min())
+        throw std::overflow_error("A row of the tableau does not fit in 64-bit integers");
+    return result;
+}
+
+static int bitWidth(long long value)
+{
+    int bits = 0;
+    for (unsigned long long it = magnitude(value); it != 0; it >>= 1)
+        bits++;
+    return bits;
+}
+
+// Greatest common divisor of the denominator and all the values.
+static long long content(const long long *values, int n, long long denominator)
+{
+    long long common = denominator;
+    for (int j = 0; j < n && common != 1; ++j)
+    {
+        if (values[j] != 0)
+            common = gcd(common, magnitude(values[j]));
+    }
+    return common;
+}
+
+// Scratch space for the int64 results of an update on an int32 row.
+static long long *scratch(int size)
+{
+    thread_local std::vector<long long> values;
+    if (values.size() < size)
+        values.resize(size);
+    return values.data();
+}
+
+Row::Row(const std::vector<Fraction> &row)
+{
+    long long denominator = 1;
+    for (auto &it : row)
+    {
+        denominator = multiply(denominator / gcd(denominator, it.denominator), it.denominator);
+    }
+    long long *values = scratch(row.size()), largest = 0;
+    for (int j = 0; j < row.size(); ++j)
+    {
+        values[j] = multiply(row[j].numerator, denominator / row[j].denominator);
+        largest |= magnitude(values[j]);
+    }
+    store(values, row.size(), denominator, largest);
+}
+
+void Row::store(const long long *values, int n, long long denominator, long long largest)
+{
+    long long divisor = content(values, n, denominator);
+    common = denominator / divisor;
+    bool narrowed = !widened;
+    widened = !fitsNarrow(largest / divisor) || !fitsNarrow(common);
+    largest = 0;
+    if (widened)
+    {
+        if (narrowed)
+            ALGOM_COUNT(promotions);
+        narrow.clear();
+        wide.resize(n);
+        for (int j = 0; j < n; ++j)
+        {
+            wide[j] = values[j] / divisor;
+            largest |= magnitude(wide[j]);
+        }
+    }
+    else
+    {
+        wide.clear();
+        narrow.resize(n);
+        for (int j = 0; j < n; ++j)
+        {
+            narrow[j] = values[j] / divisor;
+            largest |= magnitude(narrow[j]);
+        }
+    }
+    bits = bitWidth(largest) + bitWidth(common);
+}
+
+void Row::reduce()
+{
+    long long divisor = content(wide.data(), wide.size(), common);
+    long long largest = 0;
+    for (auto &it : wide)
+    {
+        if (divisor != 1)
+            it /= divisor;
+        largest |= magnitude(it);
+    }
+    common /= divisor;
+    bits = bitWidth(largest) + bitWidth(common);
+}
+
+int Row::height(int j) const
+{
+    Fraction entry = (*this)[j];
+    return bitWidth(entry.numerator) + bitWidth(entry.denominator);
+}
+
+int Row::nonZeros() const
+{
+    int count = 0;
+    for (int j = 0; j < size(); ++j)
+    {
+        if (value(j) != 0)
+            count++;
+    }
+    return count;
+}
+
+bool Row::allZero() const
+{
+    for (int j = 0; j < size(); ++j)
+    {
+        if (value(j) != 0)
+            return false;
+    }
+    return true;
+}
+
+std::vector<Fraction> Row::fractions() const
+{
+    std::vector<Fraction> row;
+    for (int j = 0; j < size(); ++j)
+    {
+        row.push_back((*this)[j]);
+    }
+    return row;
+}
+
+void Row::set(int j, const Fraction &value)
+{
+    long long scale = value.denominator / gcd(common, value.denominator);
+    int n = size();
+    long long *values = scratch(n), largest = 0;
+    long long denominator = multiply(common, scale);
+    for (int k = 0; k < n; ++k)
+    {
+        if (k == j)
+            values[k] = multiply(value.numerator, denominator / value.denominator);
+        else
+            values[k] = multiply(this->value(k), scale);
+        largest |= magnitude(values[k]);
+    }
+    store(values, n, denominator, largest);
+}
+
+void Row::push_back(const Fraction &value)
+{
+    insert(size(), value);
+}
+
+void Row::insert(int j, const Fraction &value)
+{
+    if (widened)
+        wide.insert(wide.begin() + j, 0);
+    else
+        narrow.insert(narrow.begin() + j, 0);
+    if (value.numerator != 0)
+        set(j, value);
+}
+
+void Row::erase(int j)
+{
+    int n = size() - 1;
+    long long *values = scratch(n), largest = 0;
+    for (int k = 0; k < n; ++k)
+    {
+        values[k] = value(k < j ? k : k + 1);
+        largest |= magnitude(values[k]);
+    }
+    store(values, n, common, largest);
+}
+
+void Row::negate()
+{
+    if (widened)
+    {
+        for (auto &it : wide)
+            it = -it;
+        return;
+    }
+    // -INT32_MIN does not fit, so the result goes through store.
+    int n = size();
+    long long *values = scratch(n), largest = 0;
+    for (int j = 0; j < n; ++j)
+    {
+        values[j] = -(long long)narrow[j];
+        largest |= magnitude(values[j]);
+    }
+    store(values, n, common, largest);
+}
+
+void Row::divide(const Fraction &value)
+{
+    long long numerator = value.numerator, scale = value.denominator;
+    if (numerator < 0)
+    {
+        numerator = -numerator;
+        scale = -scale;
+    }
+    long long divisor = gcd(numerator, scale);
+    numerator /= divisor;
+    scale /= divisor;
+    if (widened)
+    {
+        for (auto &it : wide)
+            it = multiply(it, scale);
+        common = multiply(common, numerator);
+        reduce();
+        return;
+    }
+    int n = size();
+    long long *values = scratch(n), largest = 0;
+    for (int j = 0; j < n; ++j)
+    {
+        values[j] = multiply(narrow[j], scale);
+        largest |= magnitude(values[j]);
+    }
+    store(values, n, multiply(common, numerator), largest);
+}
+
+void Row::eliminate(const Row &pivot, int pos)
+{
+    long long factor = value(pos);
+    if (factor == 0)
+        return;
+    // a/d - (a/d) * (b/e) = (a*e - a*b) / (d*e), with gcd(a, e) taken out first.
+    long long divisor = gcd(factor < 0 ? -factor : factor, pivot.common);
+    long long scale = pivot.common / divisor;
+    factor /= divisor;
+    int n = size();
+    if (widened)
+    {
+        long long *it = wide.data();
+        if (pivot.widened)
+        {
+            const long long *other = pivot.wide.data();
+            for (int j = 0; j < n; ++j)
+                it[j] = subtract(multiply(it[j], scale), multiply(factor, other[j]));
+        }
+        else
+        {
+            const int32_t *other = pivot.narrow.data();
+            for (int j = 0; j < n; ++j)
+                it[j] = subtract(multiply(it[j], scale), multiply(factor, other[j]));
+        }
+        common = multiply(common, scale);
+        reduce();
+        return;
+    }
+    long long *values = scratch(n), largest = 0;
+    const int32_t *it = narrow.data();
+    if (pivot.widened)
+    {
+        const long long *other = pivot.wide.data();
+        for (int j = 0; j < n; ++j)
+        {
+            values[j] = subtract(multiply(it[j], scale), multiply(factor, other[j]));
+            largest |= magnitude(values[j]);
+        }
+    }
+    else
+    {
+        // Every factor is below 2^31 here, so the int64 products cannot
+        // overflow; this is the only update that goes unchecked.
+        const int32_t *other = pivot.narrow.data();
+        for (int j = 0; j < n; ++j)
+        {
+            values[j] = it[j] * scale - factor * other[j];
+            largest |= magnitude(values[j]);
+        }
+    }
+    store(values, n, multiply(common, scale), largest);
+}
+
+bool lighterPivot(const Row &row, int j, const Row &other, int k)
+{
+    int height = row.height(j), otherHeight = other.height(k);
+    if (height != otherHeight)
+        return height < otherHeight;
+    return row.nonZeros() < other.nonZeros();
+}
+
+void Row::write(std::ostream &out) const
+{
+    long long header[4] = {size(), widened, common, bits};
+    out.write(reinterpret_cast<const char *>(header), sizeof(header));
+    if (widened)
+        out.write(reinterpret_cast<const char *>(wide.data()), wide.size() * sizeof(long long));
+    else
+        out.write(reinterpret_cast<const char *>(narrow.data()), narrow.size() * sizeof(int32_t));
+}
+
+bool Row::read(std::istream &in)
+{
+    long long header[4];
+    if (!in.read(reinterpret_cast<char *>(header), sizeof(header)) || header[0] < 0 || header[0] > (1 << 30) || header[2] <= 0)
+        return false;
+    widened = header[1] != 0;
+    common = header[2];
+    bits = header[3];
+    if (widened)
+    {
+        narrow.clear();
+        wide.resize(header[0]);
+        return bool(in.read(reinterpret_cast<char *>(wide.data()), wide.size() * sizeof(long long)));
+    }
+    wide.clear();
+    narrow.resize(header[0]);
+    return bool(in.read(reinterpret_cast<char *>(narrow.data()), narrow.size() * sizeof(int32_t)));
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "fraction.hpp"
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+// A row of rationals kept as integers over one shared denominator. Pivoting
+// on rows in this form is an integer AXPY plus one content gcd per row
+// instead of a gcd per entry. Values live in int32 while the whole row fits
+// and move to int64 only when an update leaves that range, so tableaux of
+// small-coefficient problems take a quarter of the memory of Fractions.
+// An update that leaves int64 throws std::overflow_error rather than wrap.
+// Reads still hand out reduced Fractions.
+class Row
+{
+private:
+    std::vector<int32_t> narrow;
+    std::vector<long long> wide;
+    bool widened = false;
+    long long common = 1;
+    int bits = 1;
+
+    // Reduces values / denominator and keeps them as int32 when they fit;
+    // largest is an upper bound on the magnitude of the values.
+    void store(const long long *values, int n, long long denominator, long long largest);
+    // Divides the int64 values and the denominator by their common gcd.
+    void reduce();
+
+public:
+    Row() {}
+    explicit Row(int size) : narrow(size, 0) {}
+    // Throws std::overflow_error when the common denominator or a value over
+    // it leaves int64.
+    Row(const std::vector<Fraction> &row);
+
+    int size() const { return widened ? wide.size() : narrow.size(); }
+    long long value(int j) const { return widened ? wide[j] : narrow[j]; }
+    long long denominator() const { return common; }
+    bool isWide() const { return widened; }
+    // Bits of the largest numerator plus the bits of the denominator.
+    int height() const { return bits; }
+    // Bits of the numerator and the denominator of entry j in lowest terms.
+    int height(int j) const;
+    int nonZeros() const;
+    bool isZero(int j) const { return value(j) == 0; }
+    bool allZero() const;
+    Fraction operator[](int j) const { return Fraction(value(j), common); }
+    Fraction back() const { return Fraction(value(size() - 1), common); }
+    std::vector<Fraction> fractions() const;
+
+    void set(int j, const Fraction &value);
+    void push_back(const Fraction &value);
+    // Inserts value before position j.
+    void insert(int j, const Fraction &value);
+    void erase(int j);
+    void negate();
+    void divide(const Fraction &value);
+    // this -= this[pos] * pivot, where pivot[pos] == 1.
+    void eliminate(const Row &pivot, int pos);
+
+    // The storage as it is, int32 or int64 array in one block, for
+    // checkpoints; read() takes back what write() wrote.
+    void write(std::ostream &out) const;
+    bool read(std::istream &in);
+};
+
+// True when row[j] is the cheaper exact pivot: the lower entry height first,
+// so that +-1 wins, then the sparser row, which spreads fewer updates.
+bool lighterPivot(const Row &row, int j, const Row &other, int k);
@@ -0,0 +1,123 @@
+#include "server.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <string>
+#include <sys/socket.h>
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+int main(int argc, char **argv)
+{
+    std::string input, socketPath;
+    int workers = std::max(1u, std::thread::hardware_concurrency());
+    int depth = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool valid = true;
+        if (arg == "--socket" && i + 1 < argc)
+            socketPath = argv[++i];
+        else if (arg == "--workers" && i + 1 < argc)
+            valid = (workers = std::atoi(argv[++i])) > 0;
+        else if (arg == "--depth" && i + 1 < argc)
+            valid = (depth = std::atoi(argv[++i])) > 0;
+        else if (arg[0] != '-' && input.empty())
+            input = arg;
+        else
+            valid = false;
+        if (!valid)
+        {
+            std::cerr << "./main [requests] [--socket path] [--workers N] [--depth requests]" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+    // Enough requests in flight per connection to keep every worker busy.
+    if (depth == 0)
+        depth = 4 * workers;
+    // A client that hangs up turns into a failed write, not a dead server.
+    std::signal(SIGPIPE, SIG_IGN);
+
+    if (socketPath.empty())
+    {
+        server::Pool pool(workers);
+        int in = input.empty() ? STDIN_FILENO : open(input.c_str(), O_RDONLY);
+        if (in < 0)
+        {
+            std::cerr << "Cannot open " << input << ": " << std::strerror(errno) << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        server::serve(in, STDOUT_FILENO, pool, depth);
+        return EXIT_SUCCESS;
+    }
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path))
+    {
+        std::cerr << "The socket path is too long" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    std::strcpy(address.sun_path, socketPath.c_str());
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socketPath.c_str());
+    if (listener < 0 || bind(listener, (sockaddr *)&address, sizeof(address)) < 0 || listen(listener, 64) < 0)
+    {
+        std::cerr << "Cannot listen on " << socketPath << ": " << std::strerror(errno) << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    std::cerr << "Listening on " << socketPath << " with " << workers << " workers" << std::endl;
+    // The solvers run in a child process. A crash in one of them drops the
+    // connections that child had open, and the parent starts another child
+    // on the same socket.
+    while (true)
+    {
+        pid_t child = fork();
+        if (child < 0)
+        {
+            std::cerr << "fork: " << std::strerror(errno) << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        if (child == 0)
+        {
+#ifdef __linux__
+            // Stopping the parent stops the server, not just its supervisor.
+            prctl(PR_SET_PDEATHSIG, SIGTERM);
+#endif
+            break;
+        }
+        int status = 0;
+        while (waitpid(child, &status, 0) < 0 && errno == EINTR)
+            ;
+        if (WIFSIGNALED(status))
+            std::cerr << "The solver process died of signal " << WTERMSIG(status) << ", restarting it" << std::endl;
+        else
+            exit(WIFEXITED(status) ? WEXITSTATUS(status) : EXIT_FAILURE);
+    }
+    server::Pool pool(workers);
+    while (true)
+    {
+        int client = accept(listener, nullptr, nullptr);
+        if (client < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            std::cerr << "accept: " << std::strerror(errno) << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        std::thread([client, &pool, depth]
+                    {
+                        server::serve(client, client, pool, depth);
+                        close(client);
+                    })
+            .detach();
+    }
+}
@@ -0,0 +1,403 @@
+#include "server.hpp"
+#include "gauss.hpp"
+#include "simplex/simplex.hpp"
+#include "3lab/transport.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace server
+{
+
+// Hands out the flags one by one; a flag without its value is an error.
+class Flags
+{
+private:
+    const std::vector<std::string> &flags;
+    size_t i = 0;
+
+public:
+    explicit Flags(const std::vector<std::string> &flags) : flags(flags) {}
+    bool next(std::string &flag)
+    {
+        if (i == flags.size())
+            return false;
+        flag = flags[i++];
+        return true;
+    }
+    const std::string &value()
+    {
+        if (i == flags.size())
+            throw std::invalid_argument("Missing value after " + flags[i - 1]);
+        return flags[i++];
+    }
+};
+
+static void check(bool valid, const std::string &flag)
+{
+    if (!valid)
+        throw std::invalid_argument("Bad value of " + flag);
+}
+
+static Fraction fraction(const std::string &text)
+{
+    Fraction value;
+    std::istringstream(text) >> value;
+    return value;
+}
+
+static Status solveGauss(std::istream &in, Flags flags, std::ostream *log, std::ostream &body)
+{
+    gauss::Matrix matrix(in);
+    matrix.setOutput(log);
+    bool bases = false;
+    Budget budget;
+    for (std::string flag; flags.next(flag);)
+    {
+        if (flag == "--pivot")
+            check(matrix.setPivot(flags.value()), flag);
+        else if (flag == "--bases")
+            bases = true;
+        else if (flag == "--time-limit")
+            budget.seconds = std::stod(flags.value());
+        else if (flag == "--step-limit")
+            budget.steps = std::stoll(flags.value());
+        else
+            throw std::invalid_argument("Unknown flag " + flag);
+    }
+    matrix.setBudget(budget);
+    gauss::Result result = matrix.JordanGauss();
+    body << "rank " << result.rank << "\n";
+    if (!result.solution.empty())
+    {
+        body << "solution";
+        for (const auto &it : result.solution)
+            body << " " << it;
+        body << "\n";
+    }
+    if (bases && result.status != Status::Infeasible)
+    {
+        for (const auto &basis : matrix.Basises())
+        {
+            body << "basis";
+            for (int j : basis.basis)
+                body << " x" << j + 1;
+            if (!basis.exists)
+                body << ": none";
+            for (const auto &it : basis.solution)
+                body << " " << it;
+            body << "\n";
+        }
+        if (matrix.hasMoreBasises())
+            return Status::Stopped;
+    }
+    return result.status;
+}
+
+static Status solveSimplex(std::istream &in, Flags flags, std::ostream *log, std::ostream &body)
+{
+    simplex::Matrix matrix(in);
+    matrix.setOutput(log);
+    // The pool already keeps every core busy with whole problems.
+    matrix.setThreads(1);
+    Budget budget;
+    for (std::string flag; flags.next(flag);)
+    {
+        if (flag == "--rhs" || flag == "--obj")
+        {
+            int index = std::stoi(flags.value());
+            Fraction from = fraction(flags.value()), to = fraction(flags.value());
+            check(matrix.setParameter(flag.substr(2), index, from, to), flag);
+        }
+        else if (flag == "--threads")
+            matrix.setThreads(std::stoi(flags.value()));
+        else if (flag == "--engine")
+            check(matrix.setEngine(flags.value()), flag);
+        else if (flag == "--pivot")
+            check(matrix.setPivot(flags.value()), flag);
+        else if (flag == "--cuts")
+            matrix.setCuts(std::stoi(flags.value()));
+        else if (flag == "--time-limit")
+            budget.seconds = std::stod(flags.value());
+        else if (flag == "--step-limit")
+            budget.steps = std::stoll(flags.value());
+        else
+            throw std::invalid_argument("Unknown flag " + flag);
+    }
+    matrix.setBudget(budget);
+    simplex::Result result = matrix.Simplex();
+    if (result.status == Status::Optimal || result.status == Status::Feasible)
+    {
+        body << "objective " << result.objective << "\n";
+        if (!result.solution.empty())
+        {
+            body << "solution";
+            for (const auto &it : result.solution)
+                body << " " << it;
+            body << "\n";
+        }
+    }
+    for (const auto &segment : result.segments)
+    {
+        body << "segment " << segment.from << " " << segment.to << " " << segment.value << " " << segment.slope << "\n";
+    }
+    return result.status;
+}
+
+static Status solveTransport(std::istream &in, Flags flags, std::ostream *log, std::ostream &body)
+{
+    transport::Matrix matrix(in);
+    matrix.setOutput(log);
+    transport::Solution solution(std::move(matrix));
+    solution.setThreads(1);
+    Budget budget;
+    for (std::string flag; flags.next(flag);)
+    {
+        if (flag == "--initial")
+            check(solution.setMethod(flags.value()), flag);
+        else if (flag == "--engine")
+            check(solution.setEngine(flags.value()), flag);
+        else if (flag == "--objective")
+            check(solution.setObjective(flags.value()), flag);
+        else if (flag == "--threads")
+            solution.setThreads(std::stoi(flags.value()));
+        else if (flag == "--time-limit")
+            budget.seconds = std::stod(flags.value());
+        else if (flag == "--step-limit")
+            budget.steps = std::stoll(flags.value());
+        else
+            throw std::invalid_argument("Unknown flag " + flag);
+    }
+    solution.setBudget(budget);
+    transport::Result result = solution.run();
+    if (result.status != Status::Infeasible)
+    {
+        body << "cost " << result.cost << "\n";
+        if (result.bottleneck)
+            body << "bottleneck " << result.bottleneck << "\n";
+        for (const auto &it : result.plan)
+        {
+            if (it.count > 0)
+                body << "ship " << it.row + 1 << " " << it.column + 1 << " " << it.count << "\n";
+        }
+    }
+    return result.status;
+}
+
+Response solve(const Request &request)
+{
+    Response response{request.id, "error", ""};
+    std::vector<std::string> flags = request.flags;
+    auto logging = std::find(flags.begin(), flags.end(), "--log");
+    bool withLog = logging != flags.end();
+    if (withLog)
+        flags.erase(logging);
+    std::istringstream in(request.body);
+    std::ostringstream log, body;
+    try
+    {
+        Status status;
+        if (request.kind == "gauss")
+            status = solveGauss(in, Flags(flags), withLog ? &log : nullptr, body);
+        else if (request.kind == "simplex")
+            status = solveSimplex(in, Flags(flags), withLog ? &log : nullptr, body);
+        else if (request.kind == "transport")
+            status = solveTransport(in, Flags(flags), withLog ? &log : nullptr, body);
+        else
+            throw std::invalid_argument("Unknown kind " + request.kind + ", expected gauss, simplex or transport");
+        response.status = statusName(status);
+    }
+    catch (const std::exception &error)
+    {
+        response.body = std::string(error.what()) + "\n";
+        return response;
+    }
+    response.body = log.str() + body.str();
+    return response;
+}
+
+Pool::Pool(int workers)
+{
+    for (int t = 0; t < workers; ++t)
+    {
+        threads.emplace_back([this]
+                             {
+                                 while (true)
+                                 {
+                                     std::function<void()> task;
+                                     {
+                                         std::unique_lock<std::mutex> lock(mutex);
+                                         ready.wait(lock, [this] { return stopping || !tasks.empty(); });
+                                         if (tasks.empty())
+                                             return;
+                                         task = std::move(tasks.front());
+                                         tasks.pop_front();
+                                     }
+                                     task();
+                                 }
+                             });
+    }
+}
+
+Pool::~Pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    ready.notify_all();
+    for (auto &it : threads)
+    {
+        it.join();
+    }
+}
+
+void Pool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    ready.notify_one();
+}
+
+// Buffered reads of header lines and bodies from a descriptor.
+class Reader
+{
+private:
+    int fd;
+    std::string buffer;
+    size_t begin = 0;
+
+    bool fill()
+    {
+        if (begin > 0 && begin * 2 >= buffer.size())
+        {
+            buffer.erase(0, begin);
+            begin = 0;
+        }
+        char chunk[1 << 16];
+        ssize_t count;
+        do
+            count = ::read(fd, chunk, sizeof(chunk));
+        while (count < 0 && errno == EINTR);
+        if (count <= 0)
+            return false;
+        buffer.append(chunk, count);
+        return true;
+    }
+
+public:
+    explicit Reader(int fd) : fd(fd) {}
+
+    bool line(std::string &out)
+    {
+        size_t end;
+        while ((end = buffer.find('\n', begin)) == std::string::npos)
+        {
+            if (!fill())
+                return false;
+        }
+        out.assign(buffer, begin, end - begin);
+        begin = end + 1;
+        return true;
+    }
+
+    bool bytes(size_t count, std::string &out)
+    {
+        while (buffer.size() - begin < count)
+        {
+            if (!fill())
+                return false;
+        }
+        out.assign(buffer, begin, count);
+        begin += count;
+        return true;
+    }
+};
+
+// The writing end of a connection and the requests still owed an answer.
+struct Connection
+{
+    int out;
+    std::mutex mutex;
+    std::condition_variable changed;
+    int pending = 0;
+    bool broken = false;
+
+    explicit Connection(int out) : out(out) {}
+
+    void send(const Response &response)
+    {
+        std::string frame = response.id + " " + response.status + " " + std::to_string(response.body.size()) + "\n" + response.body;
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t done = 0; !broken && done < frame.size();)
+        {
+            ssize_t count = ::write(out, frame.data() + done, frame.size() - done);
+            if (count < 0 && errno == EINTR)
+                continue;
+            broken = count <= 0;
+            done += broken ? 0 : count;
+        }
+    }
+};
+
+// A header is "<id> <kind> <length> [flags]" with a decimal length.
+static bool parseHeader(const std::string &line, Request &request, size_t &length)
+{
+    std::istringstream in(line);
+    std::string size;
+    if (!(in >> request.id >> request.kind >> size) || size.size() > 10 ||
+        !std::all_of(size.begin(), size.end(), [](char c) { return c >= '0' && c <= '9'; }))
+        return false;
+    length = std::stoull(size);
+    for (std::string flag; in >> flag;)
+    {
+        request.flags.push_back(flag);
+    }
+    return length <= (1u << 30);
+}
+
+void serve(int in, int out, Pool &pool, int depth)
+{
+    Reader reader(in);
+    Connection connection(out);
+    for (std::string line; reader.line(line);)
+    {
+        if (line.find_first_not_of(" \t\r") == std::string::npos)
+            continue;
+        Request request;
+        size_t length = 0;
+        if (!parseHeader(line, request, length))
+        {
+            // The stream cannot be trusted past a header it cannot frame.
+            connection.send({request.id.empty() ? "-" : request.id, "error", "Malformed request header\n"});
+            break;
+        }
+        if (!reader.bytes(length, request.body))
+        {
+            connection.send({request.id, "error", "The request ended before its " + std::to_string(length) + " bytes\n"});
+            break;
+        }
+        {
+            std::unique_lock<std::mutex> lock(connection.mutex);
+            connection.changed.wait(lock, [&] { return connection.pending < depth; });
+            if (connection.broken)
+                break;
+            connection.pending++;
+        }
+        pool.submit([&connection, request = std::move(request)]
+                    {
+                        connection.send(solve(request));
+                        std::lock_guard<std::mutex> lock(connection.mutex);
+                        connection.pending--;
+                        connection.changed.notify_all();
+                    });
+    }
+    std::unique_lock<std::mutex> lock(connection.mutex);
+    connection.changed.wait(lock, [&] { return connection.pending == 0; });
+}
+
+}
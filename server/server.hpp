@@ -0,0 +1,65 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// A long-running solver: clients send framed problems over one stream and
+// get the answers back tagged with their ids, as soon as each is solved, so
+// many problems can be in flight on one connection.
+//
+// A request is a header line "<id> <kind> <length> [flags]" followed by
+// exactly length bytes of the problem in the input format of the kind's
+// tool (gauss, simplex or transport). The flags are the tool's own; --log
+// also sends back everything the solver printed. A response is
+// "<id> <status> <length>" and length bytes of "key value" lines.
+namespace server
+{
+
+struct Request
+{
+    std::string id, kind;
+    std::vector<std::string> flags;
+    std::string body;
+};
+
+struct Response
+{
+    std::string id, status, body;
+};
+
+// Solves one request. A problem that cannot be read or a flag the kind does
+// not know comes back with status "error" and the reason as the body. A
+// solver that crashes (the solvers can still overflow or fault on some
+// valid problems) takes the whole process down with the requests in
+// flight; over a socket the parent process then starts a new one, and
+// clients resubmit whatever got no answer.
+Response solve(const Request &request);
+
+// Worker threads that run the solves of every connection.
+class Pool
+{
+private:
+    std::vector<std::thread> threads;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable ready;
+    bool stopping = false;
+
+public:
+    explicit Pool(int workers);
+    ~Pool();
+    int size() const { return threads.size(); }
+    void submit(std::function<void()> task);
+};
+
+// Reads requests from the in descriptor until it ends and writes the
+// responses to out, in the order they finish. At most depth requests of the
+// connection are queued or running at once; reading waits for the rest.
+// Returns when every response has been written.
+void serve(int in, int out, Pool &pool, int depth);
+
+}
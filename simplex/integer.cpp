@@ -0,0 +1,476 @@
+#include "simplex.hpp"
+#include "counters.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace simplex
+{
+
+static Fraction floorOf(const Fraction &x)
+{
+    long long value = x.numerator / x.denominator;
+    if (x.numerator < 0 && value * x.denominator != x.numerator)
+        value--;
+    return Fraction(value);
+}
+
+bool Matrix::setInteger(int index)
+{
+    if (index <= 0 || index > countOfVariables)
+        return false;
+    integer.resize(countOfVariables, false);
+    integer[index - 1] = true;
+    return true;
+}
+
+// Appends the cut row * x + s = rhs with a fresh slack s as its basic
+// variable, written in terms of the current non-basic variables.
+void Matrix::addRow(std::vector<Fraction> row, const Fraction &rhs)
+{
+    for (int i = 0; i < rows; ++i)
+    {
+        matrix[i].insert(columns - 1, Fraction(0));
+    }
+    Z.push_back(Z.back());
+    Z[columns - 1] = Fraction(0);
+    columns++;
+    row.resize(columns - 2);
+    row.push_back(Fraction(1));
+    row.push_back(rhs);
+    Row added(row);
+    for (int i = 0; i < rows; ++i)
+    {
+        added.eliminate(matrix[i], basises[i]);
+    }
+    matrix.push_back(added);
+    symbols.push_back("=");
+    basises.push_back(columns - 2);
+    CO.push_back(Fraction(-1));
+    rows++;
+}
+
+// Dual simplex on an optimal tableau whose right side went negative: keeps
+// Z non-negative and returns false if a row proves the node infeasible.
+bool Matrix::DualSimplex()
+{
+    while (true)
+    {
+        int row = -1;
+        for (int i = 0; i < rows; ++i)
+        {
+            if (matrix[i].back().numerator < 0 && (row == -1 || matrix[row].back() > matrix[i].back()))
+                row = i;
+        }
+        if (row == -1)
+            return true;
+        int column = -1;
+        Fraction mmin;
+        for (int j = 0; j < columns - 1; ++j)
+        {
+            if (matrix[row][j].numerator < 0)
+            {
+                Fraction ratio = Z[j] / -matrix[row][j];
+                if (column == -1 || mmin > ratio || (mmin == ratio && lighter(row, j, row, column)))
+                {
+                    mmin = ratio;
+                    column = j;
+                }
+            }
+        }
+        if (column == -1)
+            return false;
+        result.stats.iterations++;
+        printSimplex(row, column);
+        GaussStep(row, column);
+        free.erase(std::find(free.begin(), free.end(), column));
+        free.push_back(basises[row]);
+        basises[row] = column;
+        printSimplex();
+    }
+}
+
+void Matrix::IntegerSolution(Deadline &deadline)
+{
+    ALGOM_PHASE("IntegerSolution");
+    struct Node
+    {
+        Matrix tableau;
+        int depth;
+    };
+    auto bound = [](const Node &node) { return node.tableau.Z.back(); };
+    auto worse = [&bound](const std::unique_ptr<Node> &a, const std::unique_ptr<Node> &b) { return bound(*a) < bound(*b); };
+    auto shown = [this](const Fraction &value) { return isMax ? value : -value; };
+
+    int workers = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<std::unique_ptr<Node>> open;
+    std::vector<bool> active(workers, false);
+    std::vector<Fraction> held(workers);
+    int busy = workers;
+    long long nodes = 0;
+    bool found = false;
+    bool stopped = false;
+    Fraction incumbent;
+    std::vector<Fraction> best;
+    std::vector<int> bestBasis;
+
+    log() << "Branch and bound from the LP relaxation Z " << (isMax ? "max" : "min") << " = " << shown(Z.back())
+          << ", " << workers << " threads:" << std::endl;
+    std::unique_ptr<Node> root(new Node{*this, 0});
+    root->tableau.out = nullptr;
+    open.push_back(std::move(root));
+
+    // Best bound over the open heap and the nodes the workers hold; call under the lock.
+    auto bestBound = [&]() -> Fraction
+    {
+        bool any = found;
+        Fraction value = incumbent;
+        if (!open.empty() && (!any || value < bound(*open.front())))
+        {
+            value = bound(*open.front());
+            any = true;
+        }
+        for (int id = 0; id < workers; ++id)
+        {
+            if (active[id] && (!any || value < held[id]))
+            {
+                value = held[id];
+                any = true;
+            }
+        }
+        return value;
+    };
+    auto report = [&](int depth)
+    {
+        Fraction gap = bestBound() - incumbent;
+        double relative = 0;
+        if (incumbent.numerator != 0)
+        {
+            Fraction ratio = gap / Fraction::abs(incumbent);
+            relative = double(ratio) * 100;
+        }
+        log() << "Node " << nodes << " (depth " << depth << "): incumbent Z = " << shown(incumbent)
+              << ", bound = " << shown(bestBound()) << ", gap = " << gap
+              << " (" << std::fixed << std::setprecision(2) << relative << "%)" << std::defaultfloat << std::endl;
+    };
+
+    // Each worker dives into the better child and leaves the other one on the
+    // best-bound heap; a finished dive restarts from the heap top.
+    auto worker = [&](int id)
+    {
+        std::unique_ptr<Node> node;
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                if (!node)
+                {
+                    active[id] = false;
+                    if (--busy == 0)
+                        wake.notify_all();
+                    wake.wait(lock, [&] { return !open.empty() || busy == 0 || stopped; });
+                    if (open.empty() || stopped)
+                        return;
+                    std::pop_heap(open.begin(), open.end(), worse);
+                    node = std::move(open.back());
+                    open.pop_back();
+                    busy++;
+                }
+                if (stopped || deadline.exhausted())
+                {
+                    // The node goes back to the heap so that its bound still counts.
+                    stopped = true;
+                    open.push_back(std::move(node));
+                    std::push_heap(open.begin(), open.end(), worse);
+                    active[id] = false;
+                    busy--;
+                    wake.notify_all();
+                    return;
+                }
+                nodes++;
+                if (found && !(incumbent < bound(*node)))
+                {
+                    node.reset();
+                    continue;
+                }
+                active[id] = true;
+                held[id] = bound(*node);
+            }
+
+            Matrix &tableau = node->tableau;
+            int branch = -1;
+            Fraction distance;
+            for (int i = 0; i < tableau.rows; ++i)
+            {
+                int j = tableau.basises[i];
+                const Fraction &value = tableau.matrix[i].back();
+                if (j < countOfVariables && integer[j] && value.denominator != 1)
+                {
+                    Fraction part = value - floorOf(value);
+                    Fraction away = part > Fraction(1, 2) ? Fraction(1) - part : part;
+                    if (branch == -1 || away > distance)
+                    {
+                        distance = away;
+                        branch = i;
+                    }
+                }
+            }
+            if (branch == -1)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                active[id] = false;
+                if (!found || incumbent < bound(*node))
+                {
+                    found = true;
+                    incumbent = bound(*node);
+                    best.assign(countOfVariables, Fraction(0));
+                    for (int i = 0; i < tableau.rows; ++i)
+                    {
+                        if (tableau.basises[i] < countOfVariables)
+                            best[tableau.basises[i]] = tableau.matrix[i].back();
+                    }
+                    bestBasis = tableau.basises;
+                    report(node->depth);
+                }
+                node.reset();
+                continue;
+            }
+
+            // x <= floor on the first child, -x <= -(floor + 1) on the second.
+            int variable = tableau.basises[branch];
+            Fraction down = floorOf(tableau.matrix[branch].back());
+            std::vector<Fraction> unit(variable + 1, Fraction(0));
+            std::unique_ptr<Node> children[2];
+            Stats spent;
+            for (int k = 0; k < 2; ++k)
+            {
+                std::unique_ptr<Node> child(new Node{tableau, node->depth + 1});
+                child->tableau.result.stats = Stats();
+                unit[variable] = Fraction(k == 0 ? 1 : -1);
+                child->tableau.addRow(unit, k == 0 ? down : -(down + Fraction(1)));
+                bool feasible = child->tableau.DualSimplex();
+                spent.pivots += child->tableau.result.stats.pivots;
+                spent.iterations += child->tableau.result.stats.iterations;
+                spent.bitGrowth += child->tableau.result.stats.bitGrowth;
+                spent.peakBits = std::max(spent.peakBits, child->tableau.result.stats.peakBits);
+                if (feasible)
+                    children[k] = std::move(child);
+            }
+            node.reset();
+            if (children[0] && children[1] && bound(*children[0]) < bound(*children[1]))
+                std::swap(children[0], children[1]);
+            if (!children[0])
+                std::swap(children[0], children[1]);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            result.stats.pivots += spent.pivots;
+            result.stats.iterations += spent.iterations;
+            result.stats.bitGrowth += spent.bitGrowth;
+            result.stats.peakBits = std::max(result.stats.peakBits, spent.peakBits);
+            if (children[1])
+            {
+                open.push_back(std::move(children[1]));
+                std::push_heap(open.begin(), open.end(), worse);
+                wake.notify_one();
+            }
+            node = std::move(children[0]);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int id = 1; id < workers; ++id)
+    {
+        pool.emplace_back([&, id]
+                          {
+                              worker(id);
+                              ALGOM_MERGE_THREAD();
+                          });
+    }
+    worker(0);
+    for (auto &it : pool)
+    {
+        it.join();
+    }
+
+    log() << "Branch and bound: " << nodes << " nodes, " << result.stats.pivots << " pivots in total" << std::endl;
+    if (stopped)
+    {
+        log() << "\033[33mBranch and bound stopped by the budget with " << open.size() << " open nodes\033[0m" << std::endl;
+        if (!found)
+        {
+            log() << "No integer solution has been found yet" << std::endl;
+            result.status = Status::Stopped;
+            return;
+        }
+        log() << "Incumbent Z = " << shown(incumbent) << ", bound = " << shown(bestBound()) << ", gap = " << bestBound() - incumbent
+              << std::endl;
+        IntegerAnswer(best, incumbent, bestBasis);
+        result.status = Status::Feasible;
+        return;
+    }
+    if (!found)
+    {
+        log() << "\033[31mThe system has no integer solutions\033[0m" << std::endl;
+        noSolution = true;
+        result.status = Status::Infeasible;
+        return;
+    }
+    IntegerAnswer(best, incumbent, bestBasis);
+}
+
+void Matrix::IntegerAnswer(const std::vector<Fraction> &solution, const Fraction &value, const std::vector<int> &basis)
+{
+    result.status = Status::Optimal;
+    result.solution = solution;
+    result.objective = isMax ? value : -value;
+    result.basis = basis;
+    log() << "\033[34mINTEGER ANSWERD:\033[0m" << std::endl;
+    log() << (isMax ? "Z max = Z(" : "Z min = -Z max = Z(") << solution[0];
+    for (int i = 1; i < solution.size(); ++i)
+    {
+        log() << "; " << solution[i];
+    }
+    log() << ") = " << result.objective << std::endl;
+}
+
+bool Matrix::pureInteger() const
+{
+    if (integer.size() != countOfVariables || std::find(integer.begin(), integer.end(), false) != integer.end())
+        return false;
+    for (auto &row : matrix)
+    {
+        if (row.denominator() != 1)
+            return false;
+    }
+    return true;
+}
+
+// Drops a row whose basic variable is a cut slack together with the slack
+// column, which is a unit column with a zero reduced cost.
+void Matrix::removeRow(int row)
+{
+    int column = basises[row];
+    matrix.erase(matrix.begin() + row);
+    symbols.erase(symbols.begin() + row);
+    basises.erase(basises.begin() + row);
+    CO.erase(CO.begin() + row);
+    rows--;
+    for (auto &it : matrix)
+    {
+        it.erase(column);
+    }
+    Z.erase(Z.begin() + column);
+    columns--;
+    for (auto &it : basises)
+    {
+        if (it > column)
+            it--;
+    }
+    for (auto &it : free)
+    {
+        if (it > column)
+            it--;
+    }
+}
+
+bool Matrix::CuttingPlanes()
+{
+    ALGOM_PHASE("CuttingPlanes");
+    // Pivots multiply tableau entries pairwise, past this size the next round
+    // could overflow the long long fractions and the rest is left to branching.
+    const long long limit = 1ll << 15;
+    auto small = [limit](const std::vector<Fraction> &row)
+    {
+        for (auto &it : row)
+        {
+            if (it.denominator > limit || it.numerator > limit || -it.numerator > limit)
+                return false;
+        }
+        return true;
+    };
+    int firstCut = columns - 1;
+    int round = 0;
+    for (; round < cuts; ++round)
+    {
+        std::vector<std::pair<Fraction, int>> fractional;
+        for (int i = 0; i < rows; ++i)
+        {
+            const Fraction &value = matrix[i].back();
+            if (value.denominator != 1)
+                fractional.push_back({value - floorOf(value), i});
+        }
+        if (fractional.empty())
+            break;
+        if (!small(Z) || !std::all_of(matrix.begin(), matrix.end(), [&small](const Row &row) { return small(row.fractions()); }))
+        {
+            log() << "Gomory cuts stopped: the tableau entries have grown too large" << std::endl;
+            break;
+        }
+        std::sort(fractional.begin(), fractional.end(),
+                  [](const std::pair<Fraction, int> &a, const std::pair<Fraction, int> &b) { return a.first > b.first; });
+
+        // Gomory fractional cut of row i: sum of frac(a_ij) x_j >= frac(b_i)
+        // over the free columns, added as -sum + s = -frac(b_i).
+        std::vector<std::pair<std::vector<Fraction>, Fraction>> found;
+        for (auto &it : fractional)
+        {
+            std::vector<Fraction> row(columns - 1);
+            for (int j : free)
+            {
+                const Fraction &a = matrix[it.second][j];
+                row[j] = floorOf(a) - a;
+            }
+            found.push_back({row, -it.first});
+        }
+        for (auto &it : found)
+        {
+            addRow(it.first, it.second);
+        }
+        log() << "Cut round " << round + 1 << ": " << found.size() << " Gomory cuts added" << std::endl;
+        printSimplex();
+        if (!DualSimplex())
+        {
+            log() << "\033[31mThe system has no integer solutions\033[0m" << std::endl;
+            noSolution = true;
+            result.status = Status::Infeasible;
+            return true;
+        }
+        int purged = 0;
+        for (int i = rows - 1; i > -1; --i)
+        {
+            if (basises[i] >= firstCut && matrix[i].back().numerator > 0)
+            {
+                removeRow(i);
+                purged++;
+            }
+        }
+        log() << "Z = " << (isMax ? Z.back() : -Z.back()) << ", " << rows << " rows after purging "
+              << purged << " inactive cuts" << std::endl;
+    }
+
+    std::vector<Fraction> solution(countOfVariables, 0);
+    for (int i = 0; i < rows; ++i)
+    {
+        if (basises[i] < countOfVariables)
+        {
+            if (integer[basises[i]] && matrix[i].back().denominator != 1)
+            {
+                log() << "Gomory cuts left a fractional optimum after " << round << " rounds, branching" << std::endl;
+                return false;
+            }
+            solution[basises[i]] = matrix[i].back();
+        }
+    }
+    log() << "Gomory cuts closed the gap in " << round << " rounds" << std::endl;
+    IntegerAnswer(solution, Z.back(), basises);
+    return true;
+}
+
+}
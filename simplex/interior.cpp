@@ -0,0 +1,350 @@
+#include "simplex.hpp"
+#include "counters.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace simplex
+{
+
+static double toDouble(const Fraction &x)
+{
+    return double(x.numerator) / x.denominator;
+}
+
+// Runs f(i) for i in [from, to), strided over the threads when the range is
+// large enough to pay for starting them.
+template <class F>
+static void parallelFor(int threads, int from, int to, long long work, const F &f)
+{
+    if (threads <= 1 || work < (1 << 16) || to - from < 2)
+    {
+        for (int i = from; i < to; ++i)
+            f(i);
+        return;
+    }
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t)
+    {
+        pool.emplace_back([&, t]
+                          {
+                              for (int i = from + t; i < to; i += threads)
+                                  f(i);
+                              ALGOM_MERGE_THREAD();
+                          });
+    }
+    for (auto &it : pool)
+    {
+        it.join();
+    }
+}
+
+// Dense Cholesky factor of the normal matrix A D A^T. Pivots that vanish
+// because of dependent rows are replaced by a huge value, which zeroes the
+// matching component of every solve.
+class Normal
+{
+private:
+    int m, n, threads;
+    const std::vector<double> &A;
+    std::vector<double> L;
+
+public:
+    Normal(const std::vector<double> &A, int m, int n, int threads) : m(m), n(n), threads(threads), A(A), L(m * m) {}
+
+    void factor(const std::vector<double> &d)
+    {
+        std::vector<double> scaled(A.size());
+        for (int i = 0; i < m; ++i)
+        {
+            for (int j = 0; j < n; ++j)
+            {
+                scaled[i * n + j] = A[i * n + j] * d[j];
+            }
+        }
+        parallelFor(threads, 0, m, (long long)m * m * n, [&](int i)
+                    {
+                        for (int k = 0; k <= i; ++k)
+                        {
+                            double sum = 0;
+                            for (int j = 0; j < n; ++j)
+                                sum += scaled[i * n + j] * A[k * n + j];
+                            L[i * m + k] = sum;
+                        }
+                    });
+        double largest = 0;
+        for (int i = 0; i < m; ++i)
+        {
+            largest = std::max(largest, L[i * m + i]);
+        }
+        std::vector<double> column(m);
+        for (int k = 0; k < m; ++k)
+        {
+            double pivot = L[k * m + k];
+            if (pivot <= 1e-30 * std::max(largest, 1.0))
+                pivot = 1e128;
+            pivot = std::sqrt(pivot);
+            L[k * m + k] = pivot;
+            for (int i = k + 1; i < m; ++i)
+            {
+                L[i * m + k] /= pivot;
+                column[i] = L[i * m + k];
+            }
+            long long rest = m - k - 1;
+            parallelFor(threads, k + 1, m, rest * rest / 2, [&](int i)
+                        {
+                            double *row = &L[i * m];
+                            double factor = column[i];
+                            for (int j = k + 1; j <= i; ++j)
+                                row[j] -= factor * column[j];
+                        });
+        }
+    }
+
+    void solve(std::vector<double> &r) const
+    {
+        for (int i = 0; i < m; ++i)
+        {
+            for (int k = 0; k < i; ++k)
+                r[i] -= L[i * m + k] * r[k];
+            r[i] /= L[i * m + i];
+        }
+        for (int i = m - 1; i > -1; --i)
+        {
+            for (int k = i + 1; k < m; ++k)
+                r[i] -= L[k * m + i] * r[k];
+            r[i] /= L[i * m + i];
+        }
+    }
+};
+
+// Mehrotra predictor-corrector for min c x, A x = b, x >= 0. Returns false
+// when the iterates diverge, which happens on infeasible or unbounded
+// problems; the caller then falls back to the simplex path.
+static bool mehrotra(const std::vector<double> &A, const std::vector<double> &b, const std::vector<double> &c, int m, int n,
+                     int threads, std::vector<double> &x, std::vector<double> &s, int &iterations)
+{
+    auto times = [&](const std::vector<double> &v)
+    {
+        std::vector<double> out(m, 0);
+        for (int i = 0; i < m; ++i)
+        {
+            for (int j = 0; j < n; ++j)
+                out[i] += A[i * n + j] * v[j];
+        }
+        return out;
+    };
+    auto transposed = [&](const std::vector<double> &v)
+    {
+        std::vector<double> out(n, 0);
+        for (int i = 0; i < m; ++i)
+        {
+            for (int j = 0; j < n; ++j)
+                out[j] += A[i * n + j] * v[i];
+        }
+        return out;
+    };
+    auto norm = [](const std::vector<double> &v) { return std::sqrt(std::inner_product(v.begin(), v.end(), v.begin(), 0.0)); };
+
+    Normal normal(A, m, n, threads);
+    normal.factor(std::vector<double>(n, 1));
+    std::vector<double> y = b;
+    normal.solve(y);
+    x = transposed(y);
+    y = times(c);
+    normal.solve(y);
+    s = transposed(y);
+    for (int j = 0; j < n; ++j)
+    {
+        s[j] = c[j] - s[j];
+    }
+    double shiftX = std::max(-1.5 * *std::min_element(x.begin(), x.end()), 0.0);
+    double shiftS = std::max(-1.5 * *std::min_element(s.begin(), s.end()), 0.0);
+    for (int j = 0; j < n; ++j)
+    {
+        x[j] += shiftX;
+        s[j] += shiftS;
+    }
+    double xs = std::inner_product(x.begin(), x.end(), s.begin(), 0.0);
+    double sumX = std::accumulate(x.begin(), x.end(), 0.0), sumS = std::accumulate(s.begin(), s.end(), 0.0);
+    for (int j = 0; j < n; ++j)
+    {
+        x[j] += 0.5 * xs / std::max(sumS, 1e-12) + 1e-6;
+        s[j] += 0.5 * xs / std::max(sumX, 1e-12) + 1e-6;
+    }
+
+    double normB = norm(b), normC = norm(c);
+    std::vector<double> d(n), dx(n), ds(n), dy, rxs(n);
+    for (iterations = 0; iterations < 100; ++iterations)
+    {
+        std::vector<double> rb = times(x), rc = transposed(y);
+        for (int i = 0; i < m; ++i)
+            rb[i] -= b[i];
+        for (int j = 0; j < n; ++j)
+            rc[j] += s[j] - c[j];
+        double mu = std::inner_product(x.begin(), x.end(), s.begin(), 0.0) / n;
+        double primal = std::inner_product(c.begin(), c.end(), x.begin(), 0.0);
+        double dual = std::inner_product(b.begin(), b.end(), y.begin(), 0.0);
+        if (norm(rb) / (1 + normB) < 1e-9 && norm(rc) / (1 + normC) < 1e-9 && std::abs(primal - dual) / (1 + std::abs(primal)) < 1e-9)
+            return true;
+        if (!std::isfinite(mu) || norm(x) > 1e14 || norm(y) > 1e14)
+            return false;
+
+        for (int j = 0; j < n; ++j)
+            d[j] = x[j] / s[j];
+        normal.factor(d);
+        auto direction = [&]()
+        {
+            std::vector<double> t(n);
+            for (int j = 0; j < n; ++j)
+                t[j] = (rxs[j] - x[j] * rc[j]) / s[j];
+            dy = times(t);
+            for (int i = 0; i < m; ++i)
+                dy[i] -= rb[i];
+            normal.solve(dy);
+            std::vector<double> back = transposed(dy);
+            for (int j = 0; j < n; ++j)
+            {
+                ds[j] = -rc[j] - back[j];
+                dx[j] = (-rxs[j] - x[j] * ds[j]) / s[j];
+            }
+        };
+        auto step = [&](const std::vector<double> &v, const std::vector<double> &dv)
+        {
+            double alpha = 1;
+            for (int j = 0; j < n; ++j)
+            {
+                if (dv[j] < 0)
+                    alpha = std::min(alpha, -v[j] / dv[j]);
+            }
+            return alpha;
+        };
+
+        for (int j = 0; j < n; ++j)
+            rxs[j] = x[j] * s[j];
+        direction();
+        double alphaP = step(x, dx), alphaD = step(s, ds);
+        double affine = 0;
+        for (int j = 0; j < n; ++j)
+            affine += (x[j] + alphaP * dx[j]) * (s[j] + alphaD * ds[j]);
+        affine /= n;
+        double sigma = std::pow(affine / mu, 3);
+
+        for (int j = 0; j < n; ++j)
+            rxs[j] = x[j] * s[j] + dx[j] * ds[j] - sigma * mu;
+        direction();
+        alphaP = std::min(1.0, 0.99 * step(x, dx));
+        alphaD = std::min(1.0, 0.99 * step(s, ds));
+        for (int j = 0; j < n; ++j)
+        {
+            x[j] += alphaP * dx[j];
+            s[j] += alphaD * ds[j];
+        }
+        for (int i = 0; i < m; ++i)
+            y[i] += alphaD * dy[i];
+    }
+    return false;
+}
+
+// Solves the canonical problem with the interior-point method and crosses
+// over to an exact basis of the tableau: the columns are tried in the order
+// of their interior value, each one that is still independent becomes basic
+// through GaussStep, and a dual simplex pass repairs a basis the rounding
+// got wrong. Returns false with the tableau untouched when that fails.
+bool Matrix::InteriorPoint()
+{
+    ALGOM_PHASE("InteriorPoint");
+    int m = rows, n = columns - 1;
+    std::vector<double> A(m * n), b(m), c(n);
+    for (int i = 0; i < m; ++i)
+    {
+        for (int j = 0; j < n; ++j)
+            A[i * n + j] = toDouble(matrix[i][j]);
+        b[i] = toDouble(matrix[i].back());
+    }
+    for (int j = 0; j < n; ++j)
+    {
+        c[j] = toDouble(Z[j]);
+    }
+    int workers = threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+    std::vector<double> x, s;
+    int iterations = 0;
+    bool converged = mehrotra(A, b, c, m, n, workers, x, s, iterations);
+    result.stats.iterations += iterations;
+    if (!converged)
+    {
+        log() << "Interior point did not converge in " << iterations << " iterations, using JordanGauss" << std::endl;
+        return false;
+    }
+    double value = -std::inner_product(c.begin(), c.end(), x.begin(), 0.0);
+    log() << "Interior point: " << iterations << " iterations, Z " << (isMax ? "max" : "min") << " = " << (isMax ? value : -value)
+          << std::endl;
+
+    Matrix saved = *this;
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return x[a] / (x[a] + s[a]) > x[b] / (x[b] + s[b]); });
+    basises.assign(rows, -1);
+    int assigned = 0;
+    long long before = result.stats.pivots;
+    for (int j : order)
+    {
+        if (assigned == rows)
+            break;
+        int row = -1;
+        for (int i = 0; i < rows; ++i)
+        {
+            if (basises[i] == -1 && matrix[i][j].numerator != 0 &&
+                (row == -1 || std::abs(toDouble(matrix[i][j])) > std::abs(toDouble(matrix[row][j]))))
+                row = i;
+        }
+        if (row == -1)
+            continue;
+        GaussStep(row, j);
+        basises[row] = j;
+        assigned++;
+    }
+    for (int i = rows - 1; i > -1; --i)
+    {
+        if (basises[i] != -1)
+            continue;
+        if (matrix[i].back().numerator != 0)
+        {
+            *this = std::move(saved);
+            return false;
+        }
+        matrix.erase(matrix.begin() + i);
+        symbols.erase(symbols.begin() + i);
+        basises.erase(basises.begin() + i);
+        if (!parameterColumn.empty())
+            parameterColumn.erase(parameterColumn.begin() + i);
+        rows--;
+    }
+    free.clear();
+    for (int j = 0; j < n; ++j)
+    {
+        if (std::find(basises.begin(), basises.end(), j) == basises.end())
+            free.push_back(j);
+    }
+    CO.assign(rows, Fraction(-1));
+    bool feasible = std::none_of(matrix.begin(), matrix.end(), [](const Row &row) { return row.back().numerator < 0; });
+    if (!feasible)
+    {
+        bool optimal = std::none_of(Z.begin(), Z.end() - 1, [](const Fraction &it) { return it.numerator < 0; });
+        if (!optimal || !DualSimplex())
+        {
+            log() << "Crossover could not repair the interior basis, using JordanGauss" << std::endl;
+            Stats stats = result.stats;
+            *this = std::move(saved);
+            result.stats = stats;
+            return false;
+        }
+    }
+    log() << "Crossover: " << result.stats.pivots - before << " pivots to an exact basis" << std::endl;
+    return true;
+}
+
+}
@@ -0,0 +1,1185 @@
+#include "simplex.hpp"
+#include "counters.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <iomanip>
+#include <stdexcept>
+
+namespace simplex
+{
+
+Matrix::Matrix(std::istream &in)
+{
+    in >> rows >> columns;
+    countOfVariables = columns;
+    columns++;
+    symbols.resize(rows);
+    Z.resize(columns);
+    std::vector<Fraction> row(columns);
+    for (int i = 0; i < rows; ++i)
+    {
+        row.assign(columns, Fraction(0));
+        for (int j = 0; j < columns - 1; ++j)
+        {
+            in >> row[j];
+        }
+        in >> symbols[i];
+        in >> row[columns - 1];
+        matrix.push_back(Row(row));
+    }
+    for (int i = 0; i < columns - 1; ++i)
+    {
+        in >> Z[i];
+    }
+    Z[columns - 1] = Fraction(0);
+    std::string temp;
+    in >> temp;
+    if (temp == "max")
+        isMax = true;
+    else
+        isMax = false;
+    inputHash = hashInput();
+    // Optional integer markers after the objective: int <index> ...
+    if (in >> temp && temp == "int")
+    {
+        int index;
+        while (in >> index)
+        {
+            if (!setInteger(index))
+                throw std::invalid_argument("Unknown variable x" + std::to_string(index) + " in the integer markers");
+        }
+    }
+}
+
+Matrix::Matrix(const std::vector<std::vector<Fraction>> &constraints, const std::vector<std::string> &symbols,
+               const std::vector<Fraction> &rhs, const std::vector<Fraction> &objective, bool isMax)
+    : symbols(symbols), Z(objective), isMax(isMax)
+{
+    rows = constraints.size();
+    countOfVariables = objective.size();
+    columns = countOfVariables + 1;
+    for (int i = 0; i < rows; ++i)
+    {
+        std::vector<Fraction> row = constraints[i];
+        row.resize(countOfVariables);
+        row.push_back(rhs[i]);
+        matrix.push_back(Row(row));
+    }
+    Z.push_back(Fraction(0));
+    inputHash = hashInput();
+}
+
+unsigned long long Matrix::hashInput() const
+{
+    checkpoint::Hash hash;
+    hash.add(isMax);
+    for (int i = 0; i < rows; ++i)
+    {
+        hash.add(matrix[i]);
+        hash.add(symbols[i]);
+    }
+    for (const auto &it : Z)
+        hash.add(it);
+    return hash.get();
+}
+
+std::ostream &Matrix::log() const
+{
+    thread_local std::ostream nullStream(nullptr);
+    return out ? *out : nullStream;
+}
+
+void Matrix::printMatrix() const
+{
+    if (!out)
+        return;
+    int spacing = 9;
+
+    auto printBorder = [this](int m_columns, int spacing) -> void
+    {
+        for (int i = 0; i < m_columns; ++i)
+        {
+            log() << "+" << std::string((spacing - 1), '-');
+        }
+        log() << "+" << std::endl;
+    };
+    printBorder(columns, spacing);
+    for (int i = 0; i < rows; ++i)
+    {
+        log() << "|";
+        for (int j = 0; j < columns - 1; ++j)
+        {
+            log() << std::setw(spacing - 1) << std::right << matrix[i][j] << "|";
+        }
+        log() << "\033[33m" << std::setw(spacing - 1) << std::right << matrix[i][columns - 1] << "\033[0m|";
+        log() << std::endl;
+        printBorder(columns, spacing);
+    }
+    log() << std::endl;
+}
+
+void Matrix::printStart(const std::string &max) const
+{
+    if (!out)
+        return;
+    for (int i = 0; i < rows; ++i)
+    {
+        bool isFirst = true;
+        for (int j = 0; j < columns - 1; ++j)
+        {
+            if (matrix[i][j].numerator != 0)
+            {
+                if (matrix[i][j].numerator > -1 && !isFirst)
+                {
+                    log() << "+";
+                }
+                log() << matrix[i][j] << "(x" << j + 1 << ")";
+                isFirst = false;
+            }
+        }
+        log() << " " << symbols[i] << " ";
+        log() << matrix[i][columns - 1] << std::endl;
+    }
+    log() << "Z = ";
+    bool isFirst = true;
+    for (int i = 0; i < columns; ++i)
+    {
+        if (Z[i].numerator != 0)
+        {
+            if (Z[i].numerator > -1 && !isFirst)
+            {
+                log() << "+";
+            }
+            log() << Z[i] << "(x" << i + 1 << ")";
+            isFirst = false;
+        }
+    }
+    log() << " -> " << max << std::endl;
+}
+
+void Matrix::printSimplex(const int &row, const int &column)
+{
+    if (!out)
+        return;
+    int spacing = 9;
+    int columnsCt = columns + 1;
+    if (column != -1)
+        columnsCt++;
+    auto printBorder = [this](int m_columns, int spacing) -> void
+    {
+        for (int i = 0; i < m_columns; ++i)
+        {
+            log() << "+" << std::string((spacing - 1), '-');
+        }
+        log() << "+" << std::endl;
+    };
+    printBorder(columnsCt, spacing);
+    int half = (spacing - 2) / 2;
+    log() << "|";
+    log() << std::string(half, ' ') << "\033[33mBV\033[0m" << std::string(spacing - 3 - half, ' ') << "|";
+    log() << std::string(half + 1, ' ') << "\033[33m1\033[0m" << std::string(spacing - 3 - half, ' ') << "|";
+    for (int i = 0; i < columns - 1; ++i)
+    {
+        log() << std::string(half, ' ') << "\033[33mx" << i + 1 << "\033[0m" << std::string(spacing - 3 - half, ' ') << "|";
+    }
+    if (column != -1)
+        log() << std::string(half, ' ') << "\033[33mCO\033[0m" << std::string(spacing - 3 - half, ' ') << "|";
+    log() << std::endl;
+    printBorder(columnsCt, spacing);
+    for (int i = 0; i < rows; ++i)
+    {
+        log() << "|";
+        log() << std::string(half, ' ') << "\033[33mx" << basises[i] + 1 << "\033[0m" << std::string(spacing - 3 - half, ' ') << "|";
+        log() << "\033[32m" << std::setw(spacing - 1) << std::right << matrix[i][columns - 1] << "\033[0m|";
+        for (int j = 0; j < columns - 1; ++j)
+        {
+            if (i == row && j == column)
+                log() << "\033[31m" << std::setw(spacing - 1) << std::right << matrix[i][j] << "\033[0m|";
+            else
+                log() << std::setw(spacing - 1) << std::right << matrix[i][j] << "|";
+        }
+        if (column != -1)
+        {
+            if (CO[i].numerator > 0)
+            {
+                if (i == row)
+                    log() << "\033[31m" << std::setw(spacing - 1) << std::right << CO[i] << "\033[0m|";
+                else
+                    log() << std::setw(spacing - 1) << std::right << CO[i] << "|";
+            }
+            else
+                log() << std::setw(spacing - 1) << std::right << "- " << "|";
+        }
+        log() << std::endl;
+        printBorder(columnsCt, spacing);
+    }
+    log() << "|" << std::string(half + 1, ' ') << "\033[33mZ\033[0m" << std::string(spacing - 3 - half, ' ') << "|";
+    log() << "\033[32m" << std::setw(spacing - 1) << std::right << Z[columns - 1] << "\033[0m|";
+    for (int i = 0; i < columns - 1; ++i)
+    {
+        if (i == column)
+            log() << "\033[31m" << std::setw(spacing - 1) << std::right << Z[i] << "\033[0m|";
+        else
+            log() << std::setw(spacing - 1) << std::right << Z[i] << "|";
+    }
+    if (column != -1)
+        log() << std::string(spacing - 1, ' ') << "|";
+    log() << std::endl;
+    printBorder(columnsCt, spacing);
+    log() << std::endl;
+}
+
+bool Matrix::checkNegativElements()
+{
+    bool flag = false;
+    for (int row = 0; row < rows; ++row)
+    {
+        if (matrix[row].back().numerator < 0)
+        {
+            flag = true;
+            matrix[row].negate();
+            if (!parameterColumn.empty())
+                parameterColumn[row] = -parameterColumn[row];
+        }
+    }
+    return flag;
+}
+
+bool Matrix::checkNegativ(int i, int j)
+{
+    while (i < rows)
+    {
+        if (matrix[i][j].numerator > 0)
+            return false;
+        ++i;
+    }
+    return true;
+}
+
+void Matrix::setMaxElement(int starti, int j)
+{
+    int swapPos = -1;
+    Fraction mmin;
+    if (matrix[starti][j].numerator > 0)
+        mmin = matrix[starti].back() / matrix[starti][j];
+    else
+    {
+        for (int i = starti + 1; i < rows; ++i)
+        {
+            if (matrix[i][j].numerator > 0)
+            {
+                mmin = matrix[i].back() / matrix[i][j];
+                swapPos = i;
+                break;
+            }
+        }
+    }
+    for (int i = starti + 1; i < rows; ++i)
+    {
+        if (matrix[i][j].numerator > 0)
+        {
+            // No height tie-break here: the row this picks decides whether
+            // JordanGauss finds a feasible basis at all.
+            if (mmin > matrix[i].back() / matrix[i][j])
+            {
+                mmin = matrix[i].back() / matrix[i][j];
+                swapPos = i;
+            }
+        }
+    }
+    if (swapPos != -1)
+    {
+        std::swap(matrix[starti], matrix[swapPos]);
+        if (!parameterColumn.empty())
+            std::swap(parameterColumn[starti], parameterColumn[swapPos]);
+    }
+}
+
+bool Matrix::noSolutions()
+{
+    for (int i = rows - 1; i > -1; --i)
+    {
+        if (matrix[i][columns - 1].numerator != 0)
+        {
+            bool isZero = true;
+            for (int j = 0; j < columns - 1; ++j)
+            {
+                if (matrix[i][j].numerator != 0)
+                {
+                    isZero = false;
+                    break;
+                }
+            }
+            if (isZero)
+                return true;
+        }
+    }
+    return false;
+}
+
+bool Matrix::noSupportingSolutions()
+{
+    bool flag = false;
+    for (auto &it : matrix)
+    {
+        if (it.back().numerator < 0)
+        {
+            flag = true;
+            for (int i = 0; i < columns - 1; ++i)
+            {
+                if (it[i].numerator < 0)
+                {
+                    flag = false;
+                    break;
+                }
+            }
+            if (flag)
+                return true;
+        }
+    }
+    return flag;
+}
+
+void Matrix::removeZeroVectors()
+{
+    int rowsCt = 0;
+    for (auto &it : matrix)
+    {
+        if (it.allZero())
+        {
+            rowsCt++;
+        }
+    }
+    for (int i = 0; i < rowsCt; ++i)
+    {
+        matrix.pop_back();
+        if (!parameterColumn.empty())
+            parameterColumn.pop_back();
+    }
+    rows -= rowsCt;
+}
+
+// Only the "height" rule looks past the ratio, and only on ties.
+bool Matrix::lighter(int i, int j, int row, int column) const
+{
+    return pivot == "height" && lighterPivot(matrix[i], j, matrix[row], column);
+}
+
+void Matrix::GaussStep(const int &row, const int &pos)
+{
+    Fraction del = matrix[row][pos];
+    result.stats.pivots++;
+    int before = matrix[row].height();
+    matrix[row].divide(del);
+    result.stats.recordHeight(before, matrix[row].height());
+    if (!parameterColumn.empty())
+    {
+        parameterColumn[row] /= del;
+        for (int i = 0; i < rows; ++i)
+        {
+            if (i != row)
+                parameterColumn[i] -= parameterColumn[row] * matrix[i][pos];
+        }
+        parameterZ -= parameterColumn[row] * Z[pos];
+    }
+    if (!parameterRow.empty())
+    {
+        for (int j = 0; j < columns; ++j)
+        {
+            if (j != pos)
+                parameterRow[j] -= matrix[row][j] * parameterRow[pos];
+        }
+        parameterRow[pos] = Fraction(0);
+    }
+    for (int i = 0; i < rows; ++i)
+    {
+        if (i == row)
+            continue;
+        int before = matrix[i].height();
+        matrix[i].eliminate(matrix[row], pos);
+        result.stats.recordHeight(before, matrix[i].height());
+    }
+    for (int j = pos + 1; j < columns; ++j)
+    {
+        Z[j] -= matrix[row][j] * Z[pos];
+    }
+    for (int j = pos - 1; j > -1; --j)
+    {
+        Z[j] -= matrix[row][j] * Z[pos];
+    }
+    Z[pos].numerator = 0;
+    Z[pos].denominator = 1;
+}
+
+bool Matrix::JordanGauss()
+{
+    ALGOM_PHASE("JordanGauss");
+    int row = 0;
+    int column = 0;
+    int ct = 0;
+    for (; row < rows && column < columns - 1; ++row, ++column)
+    {
+        while (checkNegativ(row, column) && column < columns - 1)
+        {
+            column++;
+        }
+        if (column == columns - 1)
+        {
+            break;
+        }
+        setMaxElement(row, column);
+        GaussStep(row, column);
+        printMatrix();
+        ct++;
+    }
+    removeZeroVectors();
+    bool flag = true;
+    while (ct < rows && flag)
+    {
+        int row = ct;
+        int column = 0;
+        flag = false;
+        for (; row < rows && column < columns - 1; ++row, ++column)
+        {
+            while (checkNegativ(row, column) && column < columns - 1)
+            {
+                column++;
+            }
+            if (column == columns - 1)
+            {
+                break;
+            }
+            flag = true;
+            setMaxElement(row, column);
+            GaussStep(row, column);
+            printMatrix();
+            ct++;
+        }
+    }
+    if (!flag) return false;
+    flag = true;
+    while (flag)
+    {
+        flag = false;
+        for (int row = 0; row < rows; ++row)
+        {
+            if (matrix[row].back().numerator < 0)
+            {
+                flag = true;
+                bool isOkey = false;
+                for (int i = 0; i < columns - 1; ++i)
+                {
+                    if (matrix[row][i].numerator < 0)
+                    {
+                        isOkey = true;
+                        break;
+                    }
+                }
+                if (!isOkey)
+                    return false;
+                matrix[row].negate();
+                if (!parameterColumn.empty())
+                    parameterColumn[row] = -parameterColumn[row];
+                int pos = -1;
+                Fraction mmin = Fraction(-1);
+                for (int j = 0; j < columns - 1; ++j)
+                {
+                    if (matrix[row][j].numerator > 0)
+                    {
+                        if (mmin.numerator == -1)
+                        {
+                            mmin = matrix[row].back() / matrix[row][j];
+                            pos = j;
+                        }
+                        else
+                        {
+                            if (mmin > matrix[row].back() / matrix[row][j])
+                            {
+                                mmin = matrix[row].back() / matrix[row][j];
+                                pos = j;
+                            }
+                        }
+                    }
+                }
+                if (pos == -1)
+                {
+                    flag = false;
+                    break;
+                }
+                else
+                {
+                    GaussStep(row, pos);
+                }
+                printMatrix();
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+bool Matrix::makeCanon()
+{
+    ALGOM_PHASE("makeCanon");
+    bool flag = false;
+    for (int i = 0; i < rows; ++i)
+    {
+        if (symbols[i] == "<=")
+        {
+            for (int j = 0; j < rows; ++j)
+            {
+                matrix[j].insert(columns - 1, Fraction(0));
+            }
+            Z.push_back(Fraction(0));
+            columns++;
+            matrix[i].set(columns - 2, Fraction(1));
+            symbols[i] = "=";
+            flag = true;
+        }
+        else if (symbols[i] == ">=")
+        {
+            for (int j = 0; j < rows; ++j)
+            {
+                matrix[j].insert(columns - 1, Fraction(0));
+            }
+            Z.push_back(Fraction(0));
+            columns++;
+            matrix[i].set(columns - 2, Fraction(-1));
+            symbols[i] = "=";
+            flag = true;
+        }
+    }
+    if (!isMax)
+    {
+        for (int i = 0; i < columns; ++i)
+        {
+            Z[i] = -Z[i];
+        }
+        flag = true;
+    }
+    return flag;
+}
+
+void Matrix::calcBasisesIndex()
+{
+    basises.resize(rows);
+    for (int j = 0; j < columns - 1; ++j)
+    {
+        bool flag = true;
+        int count1 = 0;
+        int pos = 0;
+        for (int i = 0; i < rows; i++)
+        {
+            if (matrix[i][j] == Fraction(1))
+            {
+                count1++;
+                pos = i;
+            }
+            else if (matrix[i][j].numerator != 0)
+            {
+                flag = false;
+                break;
+            }
+        }
+        if (flag && count1 == 1)
+        {
+            basises[pos] = j;
+        }
+    }
+    // Every column that did not end up in the basis is free, including unit
+    // columns that lost their row to a later one.
+    free.clear();
+    for (int j = 0; j < columns - 1; ++j)
+    {
+        if (std::find(basises.begin(), basises.end(), j) == basises.end())
+            free.push_back(j);
+    }
+}
+
+std::pair<int, int> Matrix::negativZPos()
+{
+    std::pair<int, int> pos = {-1, -1};
+    Fraction mmax = Fraction(0);
+    for (int i = 0; i < columns - 1; ++i)
+    {
+        if (Z[i].numerator < mmax.numerator)
+        {
+            bool flag = false;
+            for (int j = 0; j < rows; j++)
+            {
+                if (matrix[j][i].numerator > 0)
+                {
+                    flag = true;
+                    break;
+                }
+            }
+            if (flag)
+            {
+                mmax = Z[i];
+                pos.second = i;
+            }
+        }
+    }
+    if (pos.second == -1)
+        return pos;
+    mmax = Fraction(-1);
+    for (int i = 0; i < rows; ++i)
+    {
+        if (matrix[i][pos.second].numerator > 0)
+        {
+            CO[i] = matrix[i].back() / matrix[i][pos.second];
+            if (mmax.numerator == -1 || mmax > CO[i] || (mmax == CO[i] && lighter(i, pos.second, pos.first, pos.second)))
+            {
+                mmax = CO[i];
+                pos.first = i;
+            }
+        }
+        else
+        {
+            CO[i] = Fraction(-1);
+        }
+    }
+    return pos;
+}
+
+bool Matrix::checkNegativZ()
+{
+    for (int i = 0; i < columns - 1; ++i)
+    {
+        if (Z[i].numerator < 0)
+            return true;
+    }
+    return false;
+}
+
+bool Matrix::SimplexStep()
+{
+    ALGOM_PHASE("SimplexStep");
+    std::pair<int, int> pos = negativZPos();
+    if (pos.second == -1)
+        return false;
+    result.stats.iterations++;
+    printSimplex(pos.first, pos.second);
+    GaussStep(pos.first, pos.second);
+    free.erase(std::find(free.begin(), free.end(), pos.second));
+    free.push_back(basises[pos.first]);
+    basises[pos.first] = pos.second;
+    printSimplex();
+    return true;
+}
+
+// The basis the iterations stopped at is feasible but not proven optimal;
+// with integer variables it is only the relaxation, so there is no plan yet.
+void Matrix::StoppedSolution()
+{
+    log() << "\033[33mStopped by the budget after " << result.stats.iterations << " iterations, Simplex() resumes from here\033[0m"
+          << std::endl;
+    if (!integer.empty())
+    {
+        log() << "No integer solution has been found yet" << std::endl;
+        result.status = Status::Stopped;
+        return;
+    }
+    std::vector<Fraction> solution(countOfVariables, 0);
+    for (int i = 0; i < rows; ++i)
+    {
+        if (basises[i] < countOfVariables)
+            solution[basises[i]] = matrix[i].back();
+    }
+    result.status = Status::Feasible;
+    result.solution = solution;
+    result.objective = isMax ? Z.back() : -Z.back();
+    result.basis = basises;
+    log() << "\033[34mFEASIBLE, NOT PROVEN OPTIMAL:\033[0m" << std::endl;
+    log() << "Z = Z(" << solution[0];
+    for (int i = 1; i < solution.size(); ++i)
+    {
+        log() << "; " << solution[i];
+    }
+    log() << ") = " << result.objective << std::endl;
+}
+
+void Matrix::saveCheckpoint() const
+{
+    ALGOM_PHASE("checkpoint");
+    bool saved = snapshots.save([this](checkpoint::Writer &out)
+                                {
+                                    out.put("algom-simplex 2");
+                                    out.put((long long)inputHash);
+                                    out.put(rows);
+                                    out.put(columns);
+                                    out.put(cuts);
+                                    out.put(matrix);
+                                    out.put(symbols);
+                                    out.put(Z);
+                                    out.put(basises);
+                                    out.put(free);
+                                    out.put(CO);
+                                    out.put(parameterColumn);
+                                    out.put(parameterRow);
+                                    out.put(parameterZ);
+                                    out.put(integer);
+                                    out.put(result.stats);
+                                });
+    if (!saved)
+        log() << "\033[31mCould not write the checkpoint\033[0m" << std::endl;
+}
+
+bool Matrix::resume(std::istream &in)
+{
+    checkpoint::Reader reader(in);
+    long long hash = 0;
+    reader.expect("algom-simplex 2");
+    reader.get(hash);
+    if (!reader || (unsigned long long)hash != inputHash)
+        return false;
+    reader.get(rows);
+    reader.get(columns);
+    reader.get(cuts);
+    reader.get(matrix);
+    reader.get(symbols);
+    reader.get(Z);
+    reader.get(basises);
+    reader.get(free);
+    reader.get(CO);
+    reader.get(parameterColumn);
+    reader.get(parameterRow);
+    reader.get(parameterZ);
+    reader.get(integer);
+    reader.get(result.stats);
+    if (!reader || matrix.size() != rows || basises.size() != rows)
+        return false;
+    paused = true;
+    log() << "Resumed from the checkpoint after " << result.stats.iterations << " iterations:" << std::endl;
+    printSimplex();
+    return true;
+}
+
+void Matrix::SimpexSolution()
+{
+    std::vector<Fraction> solution(countOfVariables, 0);
+    for (int i = 0; i < rows; ++i)
+    {
+        if (basises[i] < countOfVariables)
+        solution[basises[i]] = matrix[i].back();
+    }
+    result.status = Status::Optimal;
+    result.solution = solution;
+    result.objective = isMax ? Z.back() : -Z.back();
+    result.basis = basises;
+    int hasMoreSolutonsPos = -1;
+    for (auto &it : free)
+    {
+        if (Z[it].numerator != 0)
+            continue;
+        // On a degenerate basis, which crossover can end on, a row with a
+        // zero ratio pivots back to the same point: not a second optimum.
+        bool entering = false, degenerate = false;
+        for (int i = 0; i < rows; ++i)
+        {
+            if (matrix[i][it].numerator > 0)
+            {
+                entering = true;
+                degenerate = degenerate || matrix[i].back().numerator == 0;
+            }
+        }
+        if (entering && !degenerate)
+            hasMoreSolutonsPos = it;
+    }
+    if (hasMoreSolutonsPos > -1)
+    {
+        log() << "The solution is optimal, but not the only one, another solution:" << std::endl;
+        Fraction mmax = Fraction(-1);
+        int pos = -1;
+        for (int i = 0; i < rows; ++i)
+        {
+            if (matrix[i][hasMoreSolutonsPos].numerator > 0)
+            {
+                CO[i] = matrix[i].back() / matrix[i][hasMoreSolutonsPos];
+                if (mmax.numerator == -1 || mmax > CO[i] || (mmax == CO[i] && lighter(i, hasMoreSolutonsPos, pos, hasMoreSolutonsPos)))
+                {
+                    mmax = CO[i];
+                    pos = i;
+                }
+            }
+            else
+            {
+                CO[i] = Fraction(-1);
+            }
+        }
+        printSimplex(pos, hasMoreSolutonsPos);
+        GaussStep(pos, hasMoreSolutonsPos);
+        free.erase(std::find(free.begin(), free.end(), hasMoreSolutonsPos));
+        free.push_back(basises[pos]);
+        basises[pos] = hasMoreSolutonsPos;
+        printSimplex();
+        std::vector<Fraction> solution2(countOfVariables, 0);
+        for (int i = 0; i < rows; ++i)
+        {
+            if (basises[i] < countOfVariables)
+            solution2[basises[i]] = matrix[i].back();
+        }
+        result.alternative = true;
+        result.alternativeSolution = solution2;
+        log() << "Z(" << solution[0];
+        for (int i = 1; i < solution.size(); ++i)
+        {
+            log() << "; " << solution[i];
+        }
+        log() << ") and Z(" << solution2[0];
+        for (int i = 1; i < solution2.size(); ++i)
+        {
+            log() << "; " << solution2[i];
+        }
+        log() << ")" << std::endl;
+        log() << "\033[34mANSWERD:\033[0m" << std::endl;
+        if (isMax)
+        {
+            log() << "Z max = Z(";
+        }
+        else
+        {
+            Z.back() = -Z.back();
+            log() << "Z min = -Z max = Z(";
+        }
+        log() << solution[0] << (solution[0].numerator >= 0 ? "-" : "+") << Fraction::abs(solution[0]) << "a" << (solution2[0].numerator >= 0 ? "+" : "-") << Fraction::abs(solution2[0]) << "a";
+        for (int i = 1; i < solution.size(); ++i)
+        {
+            log() << "; " << solution[i] << (solution[i].numerator >= 0 ? "-" : "+") << Fraction::abs(solution[i]) << "a" << (solution2[i].numerator >= 0 ? "+" : "-") << Fraction::abs(solution2[i]) << "a";
+        }
+        Fraction temp = solution2[0] - solution[0];
+        log() << ") = Z(" << solution[0] << (temp.numerator >= 0 ? "+" : "") << temp << "a";
+        for (int i = 1; i < solution.size(); ++i)
+        {
+            temp = solution2[i] - solution[i];
+            log() << "; " << solution[i] << (temp.numerator >= 0 ? "+" : "") << temp << "a";
+        }
+        log() << ") = " << Z.back() << "\t 0 <= a <= 1" << std::endl;
+    }
+    else
+    {
+        log() << "\033[34mANSWERD:\033[0m" << std::endl;
+        if (isMax)
+        {
+            log() << "Z max = Z(" << solution[0];
+        }
+        else
+        {
+            Z.back() = -Z.back();
+            log() << "Z min = -Z max = Z(" << solution[0];
+        }
+        for (int i = 1; i < solution.size(); ++i)
+        {
+            log() << "; " << solution[i];
+        }
+        log() << ") = " << Z.back() << std::endl;
+    }
+}
+
+bool Matrix::setEngine(const std::string &engine)
+{
+    if (engine != "simplex" && engine != "ipm")
+        return false;
+    this->engine = engine;
+    return true;
+}
+
+bool Matrix::setPivot(const std::string &rule)
+{
+    if (rule != "first" && rule != "height")
+        return false;
+    pivot = rule;
+    growthReport = true;
+    return true;
+}
+
+bool Matrix::setParameter(const std::string &kind, int index, const Fraction &from, const Fraction &to)
+{
+    if (to < from)
+        return false;
+    if (kind == "rhs" && index > 0 && index <= rows)
+    {
+        matrix[index - 1].set(columns - 1, matrix[index - 1].back() + from);
+        parameterColumn.assign(rows, Fraction(0));
+        parameterColumn[index - 1] = Fraction(1);
+    }
+    else if (kind == "obj" && index > 0 && index <= countOfVariables)
+    {
+        Z[index - 1] += from;
+    }
+    else
+        return false;
+    parameter = kind;
+    parameterIndex = index - 1;
+    parameterFrom = from;
+    parameterTo = to;
+    return true;
+}
+
+void Matrix::printBasis(const std::vector<int> &basis) const
+{
+    std::vector<int> sorted = basis;
+    std::sort(sorted.begin(), sorted.end());
+    log() << "{ ";
+    for (int i = 0; i < sorted.size() - 1; ++i)
+    {
+        log() << "x" << sorted[i] + 1 << "; ";
+    }
+    log() << "x" << sorted.back() + 1 << " }";
+}
+
+void Matrix::ParametricSolution()
+{
+    std::vector<Segment> &segments = result.segments;
+    std::string stopReason;
+    Fraction t = parameterFrom;
+    while (true)
+    {
+        int pos = -1;
+        Fraction step;
+        if (parameter == "rhs")
+        {
+            for (int i = 0; i < rows; ++i)
+            {
+                if (parameterColumn[i].numerator < 0)
+                {
+                    Fraction ratio = matrix[i].back() / -parameterColumn[i];
+                    if (pos == -1 || step > ratio)
+                    {
+                        step = ratio;
+                        pos = i;
+                    }
+                }
+            }
+        }
+        else
+        {
+            for (int j = 0; j < columns - 1; ++j)
+            {
+                if (parameterRow[j].numerator < 0)
+                {
+                    Fraction ratio = Z[j] / -parameterRow[j];
+                    if (pos == -1 || step > ratio)
+                    {
+                        step = ratio;
+                        pos = j;
+                    }
+                }
+            }
+        }
+        Fraction next = parameterTo;
+        if (pos != -1 && t + step < parameterTo)
+            next = t + step;
+        Fraction slope = parameter == "rhs" ? parameterZ : parameterRow.back();
+        if (t < next || parameterFrom == parameterTo)
+            segments.push_back({t, next, isMax ? Z.back() : -Z.back(), isMax ? slope : -slope, basises});
+        Fraction delta = next - t;
+        if (parameter == "rhs")
+        {
+            for (int i = 0; i < rows; ++i)
+            {
+                matrix[i].set(columns - 1, matrix[i].back() + delta * parameterColumn[i]);
+            }
+            Z.back() += delta * parameterZ;
+        }
+        else
+        {
+            for (int j = 0; j < columns; ++j)
+            {
+                Z[j] += delta * parameterRow[j];
+            }
+        }
+        t = next;
+        if (pos == -1 || !(t < parameterTo))
+            break;
+
+        int row = -1, column = -1;
+        Fraction mmin;
+        CO.assign(rows, Fraction(-1));
+        if (parameter == "rhs")
+        {
+            row = pos;
+            for (int j = 0; j < columns - 1; ++j)
+            {
+                if (matrix[row][j].numerator < 0)
+                {
+                    Fraction ratio = Z[j] / -matrix[row][j];
+                    if (column == -1 || mmin > ratio || (mmin == ratio && lighter(row, j, row, column)))
+                    {
+                        mmin = ratio;
+                        column = j;
+                    }
+                }
+            }
+            if (column == -1)
+            {
+                stopReason = "the system has no supporting solutions";
+                break;
+            }
+        }
+        else
+        {
+            column = pos;
+            for (int i = 0; i < rows; ++i)
+            {
+                if (matrix[i][column].numerator > 0)
+                {
+                    CO[i] = matrix[i].back() / matrix[i][column];
+                    if (row == -1 || mmin > CO[i] || (mmin == CO[i] && lighter(i, column, row, column)))
+                    {
+                        mmin = CO[i];
+                        row = i;
+                    }
+                }
+            }
+            if (row == -1)
+            {
+                stopReason = "the space of acceptable solutions is unlimited";
+                break;
+            }
+        }
+        log() << "Breakpoint t = " << t << ":" << std::endl;
+        printSimplex(row, column);
+        GaussStep(row, column);
+        free.erase(std::find(free.begin(), free.end(), column));
+        free.push_back(basises[row]);
+        basises[row] = column;
+        printSimplex();
+    }
+
+    std::string name = (parameter == "rhs" ? "b" : "c") + std::to_string(parameterIndex + 1);
+    log() << "\033[34mPARAMETRIC ANSWERD:\033[0m " << name << " = " << name << " + t, t in [" << parameterFrom << "; " << parameterTo << "]" << std::endl;
+    for (auto &it : segments)
+    {
+        Fraction slope = it.slope;
+        Fraction intercept = it.value - slope * it.from;
+        log() << "t in [" << it.from << "; " << it.to << "]: ";
+        printBasis(it.basis);
+        log() << "  Z " << (isMax ? "max" : "min") << "(t) = " << intercept << (slope.numerator >= 0 ? "+" : "") << slope << "t" << std::endl;
+    }
+    if (!segments.empty())
+    {
+        result.objective = segments[0].value;
+        result.basis = segments[0].basis;
+    }
+    if (!stopReason.empty())
+    {
+        log() << "\033[31mFor t > " << t << " " << stopReason << ".\033[0m" << std::endl;
+    }
+}
+
+// Everything before the simplex iterations: the canonical form, a first
+// basis and the infeasibility checks. Returns false when that already
+// decided the result.
+bool Matrix::prepare()
+{
+    log() << std::endl
+              << "The initial task of linear programming:" << std::endl;
+    printStart(isMax ? "max" : "min");
+    bool flag = true;
+    for (int i = 0; i < columns; ++i)
+    {
+        if (Z[i].numerator != 0)
+        {
+            flag = false;
+            break;
+        }
+    }
+    if (flag)
+    {
+        log() << "Z " << (isMax ? "max" : "min") << " = 0" << std ::endl;
+        result.status = Status::Optimal;
+        result.objective = Fraction(0);
+        return false;
+    }
+    if (cuts > 0 && !pureInteger())
+    {
+        log() << "Gomory cuts need integer variables and coefficients everywhere, branching only" << std::endl;
+        cuts = 0;
+    }
+    log() << std::endl;
+    if (makeCanon())
+    {
+        log() << "Transition to the canonical form:" << std::endl;
+        printStart("max");
+        log() << std::endl;
+    }
+    log() << "Matrix before JordanGauss:" << std::endl;
+    printMatrix();
+    if (checkNegativElements())
+    {
+        log() << "Changed all the values on the right side to non-negative" << std::endl;
+        printMatrix();
+    }
+    for (int i = 0; i < columns - 1; ++i)
+    {
+        Z[i] = -Z[i];
+    }
+    if (parameter == "obj")
+    {
+        parameterRow.assign(columns, Fraction(0));
+        parameterRow[parameterIndex] = isMax ? Fraction(-1) : Fraction(1);
+    }
+    bool crossed = engine == "ipm" && InteriorPoint();
+    bool isGauss = crossed || JordanGauss();
+    log() << (crossed ? "Matrix after crossover:" : "Matrix after JordanGauss:") << std::endl;
+    printMatrix();
+    if (noSolutions() || noSupportingSolutions() || !isGauss)
+    {
+        log() << "\033[31mThe system has no supporting solutions\033[0m" << std::endl;
+        noSolution = true;
+        result.status = Status::Infeasible;
+        return false;
+    }
+    if (!crossed)
+        calcBasisesIndex();
+    CO.resize(rows, Fraction(-1));
+    log() << "Start Simplex:" << std::endl;
+    printSimplex();
+    return true;
+}
+
+Result Matrix::Simplex()
+{
+    Deadline deadline(budget);
+    if (!paused && !prepare())
+        return result;
+    paused = false;
+    while (SimplexStep())
+    {
+        if (checkNegativZ() && deadline.exhausted())
+        {
+            paused = true;
+            if (snapshots.enabled())
+                saveCheckpoint();
+            StoppedSolution();
+            return result;
+        }
+        if (snapshots.due())
+            saveCheckpoint();
+    }
+    if (checkNegativZ())
+    {
+        log() << "\033[31mThe space of acceptable solutions is unlimited. There is no solution.\033[0m" << std::endl;
+        noSolution = true;
+        result.status = Status::Unbounded;
+        return result;
+    }
+    if (!parameter.empty())
+        ParametricSolution();
+    else if (!integer.empty())
+    {
+        if (cuts == 0 || !CuttingPlanes())
+            IntegerSolution(deadline);
+    }
+    else
+        SimpexSolution();
+    if (growthReport)
+        log() << "Coefficient growth (" << pivot << " pivots): " << result.stats.bitGrowth << " bits over " << result.stats.pivots
+              << " pivots, peak row height " << result.stats.peakBits << " bits" << std::endl;
+    return result;
+}
+
+}
@@ -0,0 +1,132 @@
+#pragma once
+#include "checkpoint.hpp"
+#include "fraction.hpp"
+#include "result.hpp"
+#include "row.hpp"
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace simplex
+{
+
+struct Segment
+{
+    Fraction from, to, value, slope;
+    std::vector<int> basis;
+};
+
+struct Result
+{
+    Status status = Status::Optimal;
+    std::vector<Fraction> solution;
+    Fraction objective;
+    std::vector<int> basis;
+    bool alternative = false;
+    std::vector<Fraction> alternativeSolution;
+    std::vector<Segment> segments;
+    Stats stats;
+};
+
+class Matrix
+{
+private:
+    int rows, columns;
+    int countOfVariables;
+    bool noSolution = false;
+    std::vector<Row> matrix;
+    std::vector<std::string> symbols;
+    std::vector<Fraction> Z;
+    std::vector<int> basises;
+    std::vector<int> free;
+    std::vector<Fraction> CO;
+    std::string parameter;
+    int parameterIndex = -1;
+    Fraction parameterFrom, parameterTo;
+    std::vector<Fraction> parameterColumn;
+    Fraction parameterZ;
+    std::vector<Fraction> parameterRow;
+    std::vector<bool> integer;
+    int threads = 0;
+    int cuts = 0;
+    std::string engine = "simplex";
+    std::string pivot = "first";
+    bool growthReport = false;
+    Budget budget;
+    bool paused = false;
+    checkpoint::Schedule snapshots;
+    // Of the problem as it was read, before any pivot.
+    unsigned long long inputHash = 0;
+    std::ostream *out = nullptr;
+    Result result;
+    std::ostream &log() const;
+    bool checkNegativElements();
+    void setMaxElement(int i, int j);
+    bool checkNegativ(int i, int j);
+    bool noSolutions();
+    bool noSupportingSolutions();
+    void removeZeroVectors();
+    bool makeCanon();
+    void calcBasisesIndex();
+    bool lighter(int i, int j, int row, int column) const;
+    void GaussStep(const int &row, const int &pos);
+    bool SimplexStep();
+    std::pair<int, int> negativZPos();
+    bool checkNegativZ();
+    bool prepare();
+    void SimpexSolution();
+    void StoppedSolution();
+    void saveCheckpoint() const;
+    unsigned long long hashInput() const;
+    void ParametricSolution();
+    void addRow(std::vector<Fraction> row, const Fraction &rhs);
+    bool DualSimplex();
+    void IntegerSolution(Deadline &deadline);
+    void IntegerAnswer(const std::vector<Fraction> &solution, const Fraction &value, const std::vector<int> &basis);
+    bool pureInteger() const;
+    void removeRow(int row);
+    bool CuttingPlanes();
+    bool InteriorPoint();
+    void printBasis(const std::vector<int> &basis) const;
+
+public:
+    Matrix(std::istream &in);
+    Matrix(const std::vector<std::vector<Fraction>> &constraints, const std::vector<std::string> &symbols,
+           const std::vector<Fraction> &rhs, const std::vector<Fraction> &objective, bool isMax);
+    bool isMax;
+    void setOutput(std::ostream *out) { this->out = out; }
+    void printMatrix() const;
+    void printStart(const std::string &max) const;
+    void printSimplex(const int &row = -1, const int &column = -1);
+    bool JordanGauss();
+    // Solves the problem. A solve stopped by the budget returns the current
+    // basis as Status::Feasible, and the next call continues the iterations.
+    Result Simplex();
+    bool canResume() const { return paused; }
+    bool setParameter(const std::string &kind, int index, const Fraction &from, const Fraction &to);
+    // Marks x<index> (1-based) as integer; Simplex() then runs branch and bound.
+    bool setInteger(int index);
+    // Worker threads of branch and bound, 0 = one per hardware thread.
+    void setThreads(int threads) { this->threads = threads; }
+    // "simplex" (JordanGauss start) or "ipm" (interior point, then crossover).
+    bool setEngine(const std::string &engine);
+    // Tie-break of the ratio tests: "first" (the first row or column) or
+    // "height" (the pivot with the fewest bits, then the sparsest row).
+    bool setPivot(const std::string &rule);
+    // Prints the coefficient growth after Simplex(); setPivot() turns it on
+    // as well.
+    void setGrowthReport(bool report) { growthReport = report; }
+    // Steps are simplex iterations and branch-and-bound nodes. Branch and
+    // bound stops for good with its incumbent when the budget runs out.
+    void setBudget(const Budget &budget) { this->budget = budget; }
+    // Saves the tableau to path every few seconds of the simplex iterations
+    // and when the budget stops them; resume() loads such a file into a
+    // Matrix read from the same problem, and Simplex() then goes on from it.
+    void setCheckpoint(const std::string &path, double seconds) { snapshots.set(path, seconds); }
+    bool resume(std::istream &in);
+    // Rounds of Gomory cuts before branching, pure integer problems only.
+    void setCuts(int cuts) { this->cuts = cuts; }
+};
+
+}